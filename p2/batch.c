@@ -0,0 +1,94 @@
+/**
+ @file batch.c
+ @author Matthew Kierski (mdkiersk)
+ Checks a stream of puzzles chunk by chunk. Each chunk is read, checked on the worker pool and
+ then printed in order, so memory use stays bounded no matter how long the stream is.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "batch.h"
+#include "puzzle.h"
+#include "pool.h"
+#include "util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+/** Number of puzzles read and checked together before their results are printed */
+#define CHUNK_PUZZLES 1024
+
+/** Puzzles being checked together */
+typedef struct {
+    /** Puzzles in this chunk */
+    Puzzle *puzzles;
+
+    /** How to check each puzzle */
+    CheckOptions options;
+} Chunk;
+
+/**
+ Pool job that checks one puzzle of a chunk
+ @param context the chunk being checked
+ @param index index of the puzzle within the chunk
+ */
+static void checkJob(void *context, int index)
+{
+    Chunk *chunk = context;
+    checkPuzzle(&chunk->puzzles[index], &chunk->options);
+}
+
+extern bool runBatch(FILE *fp, CheckOptions const *options, int threads, bool reportStats)
+{
+    Chunk chunk = { malloc(sizeof(Puzzle) * CHUNK_PUZZLES), *options };
+    if (!chunk.puzzles) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+    //Puzzles are already checked in parallel, so each one is searched on a single thread
+    chunk.options.threads = 1;
+    long total = 0;
+    SolveStats stats = { 0 };
+    bool wellFormed = true;
+    bool more = true;
+    double start = now();
+    while (more) {
+        //Read a chunk, stopping early at the end of input or at a malformed puzzle
+        int count = 0;
+        while (count < CHUNK_PUZZLES) {
+            if (!readPuzzle(fp, &chunk.puzzles[count])) {
+                more = false;
+                break;
+            }
+            if (chunk.puzzles[count++].outcome != PUZZLE_UNCHECKED) {
+                wellFormed = more = false;
+                break;
+            }
+        }
+
+        runPool(threads, count, checkJob, &chunk);
+
+        for (int i = 0; i < count; i++) {
+            printPuzzle(&chunk.puzzles[i], stdout);
+            addStats(&stats, &chunk.puzzles[i].stats);
+            freePuzzle(&chunk.puzzles[i]);
+        }
+        total += count;
+    }
+    double elapsed = now() - start;
+    free(chunk.puzzles);
+
+    fflush(stdout);
+    fprintf(stderr, "%ld puzzles in %.3f seconds (%.1f puzzles/sec)\n", total, elapsed,
+            elapsed > 0 ? total / elapsed : 0.0);
+    if (options->cache) {
+        long hits;
+        long misses;
+        cacheCounts(options->cache, &hits, &misses);
+        fprintf(stderr, "Cache: %ld hits, %ld misses\n", hits, misses);
+    }
+    if (reportStats) {
+        printStats(&stats, stderr);
+    }
+    return wellFormed;
+}
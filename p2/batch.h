@@ -0,0 +1,27 @@
+/**
+ @file batch.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the batch component, which checks a whole stream of puzzles in one process using
+ every available core.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "puzzle.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+/**
+ Reads puzzles from a stream until it runs out, checking them in parallel and printing each
+ result to standard output in input order. The number of puzzles checked and the rate at which
+ they were checked are reported on standard error. Reading stops at the first malformed puzzle.
+ @param fp stream of puzzles
+ @param options how to check each puzzle; each one is checked on a single thread
+ @param threads number of worker threads to use
+ @param reportStats true to also report search counters, totalled over every puzzle
+ @return false if a malformed puzzle was found or memory ran out, true otherwise
+ */
+bool runBatch(FILE *fp, CheckOptions const *options, int threads, bool reportStats);
+
+#endif
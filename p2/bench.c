@@ -0,0 +1,273 @@
+/**
+ @file bench.c
+ @author Matthew Kierski (mdkiersk)
+ Benchmark for the solver. It checks a fixed corpus of puzzles, the files named on the command
+ line followed by sets of hard 9x9 and 16x16 puzzles generated from fixed seeds, and prints a
+ table of search counters and times for every puzzle along with totals, so solver changes can
+ be compared from one release to the next.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "solve.h"
+#include "puzzle.h"
+#include "generate.h"
+#include "util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+//Prefix of the command-line option that selects an engine
+#define ENGINE_OPTION "--engine="
+//Prefix of the command-line option that sets how many times each puzzle is checked
+#define REPEAT_OPTION "--repeat="
+//Prefix of the command-line option that sets the number of generated 9x9 puzzles
+#define HARD_9_OPTION "--hard9="
+//Prefix of the command-line option that sets the number of generated 16x16 puzzles
+#define HARD_16_OPTION "--hard16="
+//Prefix of the command-line option that gives the bitmask engine a nogood table of this many MB
+#define NOGOODS_OPTION "--nogoods="
+//Bytes in a megabyte
+#define MEGABYTE (1024L * 1024L)
+//Number of times each puzzle is checked by default; the fastest time is reported
+#define DEFAULT_REPEAT 5
+//Number of hard 9x9 puzzles generated by default
+#define DEFAULT_HARD_9 20
+//Number of hard 16x16 puzzles generated by default
+#define DEFAULT_HARD_16 4
+//Number of 9x9 puzzles generated to pick each hard one from; most minimal 9x9 puzzles take the
+//propagate engine only a few nodes, so it takes this many to find ones that need real search
+#define CANDIDATES_9 256
+//Number of 16x16 puzzles generated to pick each hard one from; these are hard enough already
+#define CANDIDATES_16 1
+//Longest puzzle name that fits in the table
+#define NAME_LEN 32
+//Milliseconds in a second
+#define MILLIS 1000.0
+//Command-line usage message
+#define USAGE "usage: bench [--engine=propagate|bitmask|dlx] [--repeat=n] [--hard9=n] " \
+    "[--hard16=n] [--nogoods=mb] [puzzles.txt ...]\n"
+
+/** Totals over every puzzle benchmarked */
+typedef struct {
+    /** Number of puzzles */
+    int puzzles;
+
+    /** Search counters added up over every puzzle, with the fastest time for each */
+    SolveStats stats;
+} Totals;
+
+/**
+ Describes the outcome of checking a puzzle in a word or two
+ @param outcome outcome to describe
+ @return description of the outcome
+ */
+static char const *describe(Outcome outcome)
+{
+    switch (outcome) {
+    case PUZZLE_VALID:
+        return "Valid";
+    case PUZZLE_SOLVED:
+        return "Solved";
+    case PUZZLE_BAD_SIZE:
+        return "Invalid size";
+    case PUZZLE_BAD_INPUT:
+        return "Invalid input";
+    case PUZZLE_NO_MEMORY:
+        return "Out of memory";
+    default:
+        return "Invalid";
+    }
+}
+
+/**
+ Checks a puzzle several times, each time on a fresh copy of its grid, and prints a row of the
+ table for it with the fastest time
+ @param name name of the puzzle
+ @param puzzle puzzle to benchmark; its grid is left as it was read
+ @param options how to check the puzzle
+ @param repeat number of times to check the puzzle
+ @param totals totals to add the puzzle to
+ */
+static void benchmark(char const *name, Puzzle const *puzzle, CheckOptions const *options,
+                      int repeat, Totals *totals)
+{
+    Puzzle copy = *puzzle;
+    double best = 0.0;
+    if (puzzle->outcome == PUZZLE_UNCHECKED) {
+        copy.grid = malloc(sizeof(int) * puzzle->size * puzzle->size);
+        if (!copy.grid) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int run = 0; run < repeat; run++) {
+            memcpy(copy.grid, puzzle->grid, sizeof(int) * puzzle->size * puzzle->size);
+            copy.outcome = PUZZLE_UNCHECKED;
+            double start = now();
+            checkPuzzle(&copy, options);
+            double elapsed = now() - start;
+            if (run == 0 || elapsed < best) {
+                best = elapsed;
+            }
+        }
+        free(copy.grid);
+    }
+    copy.stats.seconds = best;
+    printf("%-*s %5d %-13s %10ld %10ld %10ld %12ld %5d %10.3f\n", NAME_LEN, name,
+           puzzle->size, describe(copy.outcome), copy.stats.nodes, copy.stats.backtracks,
+           copy.stats.pruned, copy.stats.propagations, copy.stats.maxDepth, best * MILLIS);
+    totals->puzzles++;
+    addStats(&totals->stats, &copy.stats);
+}
+
+/**
+ Benchmarks every puzzle in a file. A file holding several puzzles gets a row for each,
+ numbered from 1.
+ @param fileName name of the file
+ @param options how to check each puzzle
+ @param repeat number of times to check each puzzle
+ @param totals totals to add the puzzles to
+ @return false if the file couldn't be opened, true otherwise
+ */
+static bool benchmarkFile(char const *fileName, CheckOptions const *options, int repeat,
+                          Totals *totals)
+{
+    FILE *fp = fopen(fileName, "r");
+    if (!fp) {
+        fprintf(stderr, "Can't open file: %s\n", fileName);
+        return false;
+    }
+    Puzzle puzzles[2];
+    int count = 0;
+    bool more = readPuzzle(fp, &puzzles[0]);
+    while (more) {
+        //Read one puzzle ahead to find out whether the file holds more than one
+        Puzzle *puzzle = &puzzles[count % 2];
+        bool wellFormed = puzzle->outcome == PUZZLE_UNCHECKED;
+        more = wellFormed && readPuzzle(fp, &puzzles[(count + 1) % 2]);
+        count++;
+        char name[NAME_LEN + 1];
+        if (count == 1 && !more) {
+            snprintf(name, sizeof(name), "%s", fileName);
+        }
+        else {
+            snprintf(name, sizeof(name), "%s#%d", fileName, count);
+        }
+        benchmark(name, puzzle, options, repeat, totals);
+        freePuzzle(puzzle);
+    }
+    fclose(fp);
+    return true;
+}
+
+/**
+ Generates hard puzzles of one size and benchmarks each of them. Each one is the puzzle that
+ takes the propagate engine the most search nodes out of several candidates, every candidate
+ having as few clues as the generator can leave. Seeds are fixed, so every run uses the same
+ puzzles.
+ @param n dimension of subgrids
+ @param count number of puzzles to generate
+ @param candidates number of candidates to pick each puzzle from
+ @param options how to check each puzzle
+ @param repeat number of times to check each puzzle
+ @param totals totals to add the puzzles to
+ */
+static void benchmarkHard(int n, int count, int candidates, CheckOptions const *options,
+                          int repeat, Totals *totals)
+{
+    int size = n * n;
+    Puzzle puzzle = { .n = n, .size = size, .grid = malloc(sizeof(int) * size * size),
+                      .outcome = PUZZLE_UNCHECKED };
+    int (*grid)[size] = malloc(sizeof(int) * size * size);
+    int (*solved)[size] = malloc(sizeof(int) * size * size);
+    if (!puzzle.grid || !grid || !solved) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 1; i <= count; i++) {
+        long mostNodes = -1;
+        for (int j = 0; j < candidates; j++) {
+            generatePuzzle(n, size, grid, 0, (i - 1) * candidates + j + 1);
+            memcpy(solved, grid, sizeof(int) * size * size);
+            SolveStats stats;
+            solveWith(ENGINE_PROPAGATE, n, size, solved, &stats);
+            if (stats.nodes > mostNodes) {
+                mostNodes = stats.nodes;
+                memcpy(puzzle.grid, grid, sizeof(int) * size * size);
+            }
+        }
+        char name[NAME_LEN + 1];
+        snprintf(name, sizeof(name), "hard-%dx%d-%02d", size, size, i);
+        benchmark(name, &puzzle, options, repeat, totals);
+    }
+    free(grid);
+    free(solved);
+    freePuzzle(&puzzle);
+}
+
+/**
+ Runs the benchmark and prints its table
+ @param argc number of command line arguments
+ @param argv command line arguments: options, then the files of the corpus
+ @return exit status
+ */
+int main(int argc, char *argv[])
+{
+    CheckOptions options = { ENGINE_PROPAGATE, 1, false, 0, NULL, { 0, REPLACE_SHALLOW } };
+    int repeat = DEFAULT_REPEAT;
+    int hard9 = DEFAULT_HARD_9;
+    int hard16 = DEFAULT_HARD_16;
+    int first = 1;
+    for (; first < argc && strncmp(argv[first], "--", 2) == 0; first++) {
+        char const *arg = argv[first];
+        if (strncmp(arg, ENGINE_OPTION, strlen(ENGINE_OPTION)) == 0 &&
+            parseEngine(arg + strlen(ENGINE_OPTION), &options.engine)) {
+            continue;
+        }
+        if (strncmp(arg, REPEAT_OPTION, strlen(REPEAT_OPTION)) == 0) {
+            repeat = atoi(arg + strlen(REPEAT_OPTION));
+            if (repeat > 0) {
+                continue;
+            }
+        }
+        if (strncmp(arg, HARD_9_OPTION, strlen(HARD_9_OPTION)) == 0) {
+            hard9 = atoi(arg + strlen(HARD_9_OPTION));
+            if (hard9 >= 0) {
+                continue;
+            }
+        }
+        if (strncmp(arg, HARD_16_OPTION, strlen(HARD_16_OPTION)) == 0) {
+            hard16 = atoi(arg + strlen(HARD_16_OPTION));
+            if (hard16 >= 0) {
+                continue;
+            }
+        }
+        if (strncmp(arg, NOGOODS_OPTION, strlen(NOGOODS_OPTION)) == 0) {
+            long megabytes = atol(arg + strlen(NOGOODS_OPTION));
+            options.nogoods.bytes = megabytes * MEGABYTE;
+            if (megabytes > 0) {
+                continue;
+            }
+        }
+        fprintf(stderr, "%s", USAGE);
+        return EXIT_FAILURE;
+    }
+
+    printf("%-*s %5s %-13s %10s %10s %10s %12s %5s %10s\n", NAME_LEN, "Puzzle", "Size",
+           "Result", "Nodes", "Backtracks", "Pruned", "Propagations", "Depth", "Time (ms)");
+    Totals totals = { 0 };
+    bool opened = true;
+    for (int i = first; i < argc; i++) {
+        opened = benchmarkFile(argv[i], &options, repeat, &totals) && opened;
+    }
+    benchmarkHard(3, hard9, CANDIDATES_9, &options, repeat, &totals);
+    benchmarkHard(4, hard16, CANDIDATES_16, &options, repeat, &totals);
+
+    printf("%-*s %5s %-13s %10ld %10ld %10ld %12ld %5d %10.3f\n", NAME_LEN, "Total", "", "",
+           totals.stats.nodes, totals.stats.backtracks, totals.stats.pruned,
+           totals.stats.propagations, totals.stats.maxDepth, totals.stats.seconds * MILLIS);
+    printf("%d puzzles, %.3f ms each on average\n", totals.puzzles,
+           totals.puzzles ? totals.stats.seconds * MILLIS / totals.puzzles : 0.0);
+    return opened ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,262 @@
+/**
+ @file board.c
+ @author Matthew Kierski (mdkiersk)
+ Keeps a grid that is edited one cell at a time. For every row, column and subgrid the board
+ counts how often each digit appears, so an edit only touches the three units of its cell, and
+ a running total of repeated digits gives the conflict state without rescanning the grid.
+ Solvability is decided with a libsudoku context created along with the board, and the
+ solution it finds is kept for later queries.
+ */
+
+#include "board.h"
+#include "libsudoku.h"
+#include "mask.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+/** Number of kinds of unit: rows, columns and subgrids */
+#define UNIT_KINDS 3
+
+/** What is known about whether the current board can be solved */
+typedef enum {
+    /** Nothing; the solver has to be run */
+    CACHE_UNKNOWN,
+
+    /** Solvable, and solution holds a completion of the board */
+    CACHE_SOLVABLE,
+
+    /** Not solvable */
+    CACHE_UNSOLVABLE
+} Cache;
+
+/** A grid being edited, with its conflict state and cached solution */
+struct Board {
+    /** Dimension of subgrids */
+    int n;
+
+    /** Dimension of entire grid */
+    int size;
+
+    /** size * size cell values in row-major order, 0 for empty */
+    int *grid;
+
+    /** For each of the UNIT_KINDS * size units, the number of times each digit from 1 to
+     size appears in it, stored at unit * (size + 1) + digit */
+    int *counts;
+
+    /** For each unit, the digits that appear in it at least once */
+    Mask *used;
+
+    /** Number of (unit, digit) pairs where the digit appears more than once */
+    int conflicts;
+
+    /** Number of filled cells */
+    int filled;
+
+    /** What is known about solvability */
+    Cache cache;
+
+    /** A completion of the board, valid when cache is CACHE_SOLVABLE */
+    int *solution;
+
+    /** Solver context, reused for every query */
+    SudokuContext *ctx;
+};
+
+/**
+ Finds the units a cell belongs to
+ @param board board the cell is on
+ @param row row of the cell
+ @param col column of the cell
+ @param units filled in with the cell's row, column and subgrid units
+ */
+static void unitsOf(Board const *board, int row, int col, int units[UNIT_KINDS])
+{
+    int n = board->n;
+    units[0] = row;
+    units[1] = board->size + col;
+    units[2] = 2 * board->size + (row / n) * n + col / n;
+}
+
+/**
+ Adds or removes one occurrence of a digit in every unit of a cell, keeping the used masks
+ and the conflict total up to date
+ @param board board to update
+ @param row row of the cell
+ @param col column of the cell
+ @param digit digit being added or removed, from 1 to size
+ @param change 1 to add the digit, -1 to remove it
+ */
+static void countDigit(Board *board, int row, int col, int digit, int change)
+{
+    int units[UNIT_KINDS];
+    unitsOf(board, row, col, units);
+    for (int k = 0; k < UNIT_KINDS; k++) {
+        int *count = &board->counts[units[k] * (board->size + 1) + digit];
+        int before = *count;
+        *count += change;
+        //A unit's pair only starts or stops conflicting as its count crosses between 1 and 2
+        if (before == 1 && *count == 2) {
+            board->conflicts++;
+        }
+        else if (before == 2 && *count == 1) {
+            board->conflicts--;
+        }
+        if (*count == 0) {
+            board->used[units[k]] &= ~digitBit(digit);
+        }
+        else {
+            board->used[units[k]] |= digitBit(digit);
+        }
+    }
+}
+
+extern Board *newBoard(int size)
+{
+    int n = 0;
+    for (int k = MIN_SUBGRID; k <= MAX_SUBGRID; k++) {
+        if (k * k == size) {
+            n = k;
+        }
+    }
+    if (n == 0) {
+        return NULL;
+    }
+    Board *board = malloc(sizeof(Board));
+    if (!board) {
+        return NULL;
+    }
+    board->n = n;
+    board->size = size;
+    board->grid = calloc(size * size, sizeof(int));
+    board->counts = calloc(UNIT_KINDS * size * (size + 1), sizeof(int));
+    board->used = calloc(UNIT_KINDS * size, sizeof(Mask));
+    board->solution = malloc(sizeof(int) * size * size);
+    board->ctx = sudokuCreate(size);
+    board->conflicts = 0;
+    board->filled = 0;
+    board->cache = CACHE_UNKNOWN;
+    if (!board->grid || !board->counts || !board->used || !board->solution || !board->ctx) {
+        freeBoard(board);
+        return NULL;
+    }
+    return board;
+}
+
+extern void freeBoard(Board *board)
+{
+    if (board) {
+        free(board->grid);
+        free(board->counts);
+        free(board->used);
+        free(board->solution);
+        sudokuDestroy(board->ctx);
+        free(board);
+    }
+}
+
+extern bool placeDigit(Board *board, int row, int col, int digit)
+{
+    int size = board->size;
+    if (row < 0 || row >= size || col < 0 || col >= size || digit < 0 || digit > size) {
+        return false;
+    }
+    int *cell = &board->grid[row * size + col];
+    if (*cell == digit) {
+        return true;
+    }
+    int old = *cell;
+    if (old != 0) {
+        countDigit(board, row, col, *cell, -1);
+        board->filled--;
+    }
+    if (digit != 0) {
+        countDigit(board, row, col, digit, 1);
+        board->filled++;
+    }
+    *cell = digit;
+
+    //Clearing a cell keeps a found solution valid, and placing its digit from the solution does
+    //too. Placing a digit in an empty cell can only keep an unsolvable board unsolvable, but
+    //taking a digit away, even to put another in its place, can make it solvable.
+    if (board->cache == CACHE_SOLVABLE && digit != 0 &&
+        board->solution[row * size + col] != digit) {
+        board->cache = CACHE_UNKNOWN;
+    }
+    else if (board->cache == CACHE_UNSOLVABLE && old != 0) {
+        board->cache = CACHE_UNKNOWN;
+    }
+    return true;
+}
+
+extern int boardDigit(Board const *board, int row, int col)
+{
+    return board->grid[row * board->size + col];
+}
+
+extern bool cellConflicts(Board const *board, int row, int col)
+{
+    int digit = boardDigit(board, row, col);
+    if (digit == 0) {
+        return false;
+    }
+    int units[UNIT_KINDS];
+    unitsOf(board, row, col, units);
+    for (int k = 0; k < UNIT_KINDS; k++) {
+        if (board->counts[units[k] * (board->size + 1) + digit] > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+extern BoardState boardState(Board const *board)
+{
+    if (board->conflicts > 0) {
+        return BOARD_CONFLICT;
+    }
+    return board->filled == board->size * board->size ? BOARD_COMPLETE : BOARD_INCOMPLETE;
+}
+
+extern bool boardSolvable(Board *board)
+{
+    if (board->cache == CACHE_UNKNOWN) {
+        bool solvable = false;
+        if (board->conflicts == 0) {
+            if (sudokuLoad(board->ctx, board->grid) == SUDOKU_RUNNING &&
+                sudokuStep(board->ctx, 0) == SUDOKU_SOLVED) {
+                sudokuSolution(board->ctx, board->solution);
+                solvable = true;
+            }
+        }
+        board->cache = solvable ? CACHE_SOLVABLE : CACHE_UNSOLVABLE;
+    }
+    return board->cache == CACHE_SOLVABLE;
+}
+
+extern bool boardHint(Board *board, int *row, int *col, int *digit)
+{
+    if (!boardSolvable(board)) {
+        return false;
+    }
+    int size = board->size;
+    int fewest = size + 1;
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            if (board->grid[r * size + c] != 0) {
+                continue;
+            }
+            int units[UNIT_KINDS];
+            unitsOf(board, r, c, units);
+            Mask used = board->used[units[0]] | board->used[units[1]] | board->used[units[2]];
+            int candidates = size - countDigits(used);
+            if (candidates < fewest) {
+                fewest = candidates;
+                *row = r;
+                *col = c;
+                *digit = board->solution[r * size + c];
+            }
+        }
+    }
+    return fewest <= size;
+}
@@ -0,0 +1,99 @@
+/**
+ @file board.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the board component, which keeps a grid that is edited one cell at a time. Every
+ edit updates the board's conflict state in constant time, and the answers to "is this still
+ solvable?" and "what is a good next move?" are cached and reused across edits whenever the
+ edits can't have changed them.
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdbool.h>
+
+/** A grid being edited, with its conflict state and cached solution */
+typedef struct Board Board;
+
+/** Overall state of a board */
+typedef enum {
+    /** Some digit appears twice in a row, column or subgrid */
+    BOARD_CONFLICT,
+
+    /** No conflicts, but some cells are still empty */
+    BOARD_INCOMPLETE,
+
+    /** Every cell is filled and there are no conflicts */
+    BOARD_COMPLETE
+} BoardState;
+
+/**
+ Creates an empty board
+ @param size dimension of entire grid: 4, 9, 16, 25, 36 or 49
+ @return new board, or NULL if the size is unsupported or memory ran out
+ */
+Board *newBoard(int size);
+
+/**
+ Frees a board and everything it holds
+ @param board board to free, or NULL
+ */
+void freeBoard(Board *board);
+
+/**
+ Places a digit in a cell, replacing whatever was there, or clears the cell
+ @param board board to edit
+ @param row row of the cell, from 0
+ @param col column of the cell, from 0
+ @param digit digit to place, or 0 to clear the cell
+ @return false if the cell or digit is out of range, true otherwise
+ */
+bool placeDigit(Board *board, int row, int col, int digit);
+
+/**
+ Gives the digit in a cell
+ @param board board to look at
+ @param row row of the cell, from 0
+ @param col column of the cell, from 0
+ @return digit in the cell, or 0 if it is empty
+ */
+int boardDigit(Board const *board, int row, int col);
+
+/**
+ Checks whether a cell's digit also appears elsewhere in its row, column or subgrid
+ @param board board to look at
+ @param row row of the cell, from 0
+ @param col column of the cell, from 0
+ @return true if the cell is filled and its digit is repeated in one of its units
+ */
+bool cellConflicts(Board const *board, int row, int col);
+
+/**
+ Gives the overall state of a board
+ @param board board to look at
+ @return BOARD_CONFLICT, BOARD_INCOMPLETE or BOARD_COMPLETE
+ */
+BoardState boardState(Board const *board);
+
+/**
+ Determines whether the digits on a board can be completed to a solution. The answer is kept
+ and reused until an edit could change it: clearing a cell or placing a digit that agrees with
+ the solution found keeps it solvable, and only placing a digit in an empty cell keeps an
+ unsolvable board unsolvable.
+ @param board board to look at
+ @return true if the board has a solution, false otherwise
+ */
+bool boardSolvable(Board *board);
+
+/**
+ Suggests a next move: the empty cell with the fewest candidates, and its digit in the
+ cached solution
+ @param board board to look at
+ @param row filled in with the row of the cell, from 0
+ @param col filled in with the column of the cell, from 0
+ @param digit filled in with the digit to place
+ @return false if the board is full or unsolvable, true otherwise
+ */
+bool boardHint(Board *board, int *row, int *col, int *digit);
+
+#endif
@@ -0,0 +1,272 @@
+/**
+ @file cache.c
+ @author Matthew Kierski (mdkiersk)
+ Keeps canonical puzzles in a set-associative table: a puzzle's hash picks a set of a few
+ entries, and when the set is full the least recently used entry in it is replaced. Memory use
+ is bounded by the capacity, and no lookup ever looks past one set. A lock makes the cache safe
+ to share between the worker threads of a batch.
+ */
+
+#include "cache.h"
+#include "canon.h"
+#include "validate.h"
+#include "puzzle.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/** Number of entries in each set */
+#define WAYS 4
+
+/** A canonical puzzle in the cache */
+typedef struct {
+    /** Dimension of entire grid, or 0 if the entry is empty */
+    int size;
+
+    /** True if the puzzle has a solution */
+    bool solved;
+
+    /** Hash of the puzzle's cells */
+    uint64_t hash;
+
+    /** When the entry was last used, counted in lookups and stores */
+    unsigned long used;
+
+    /** Dynamically allocated cells of the puzzle followed by those of its solution */
+    unsigned char *cells;
+} Entry;
+
+/** Map from canonical puzzles to solutions */
+struct SolutionCache {
+    /** Number of sets */
+    long sets;
+
+    /** WAYS entries for each set */
+    Entry *entries;
+
+    /** Number of lookups and stores so far, used to order entries by use */
+    unsigned long clock;
+
+    /** Number of lookups that found their puzzle */
+    long hits;
+
+    /** Number of lookups that didn't */
+    long misses;
+
+    /** Lock protecting everything above */
+    pthread_mutex_t lock;
+};
+
+/**
+ Hashes the cells of a puzzle (FNV-1a)
+ @param size dimension of entire grid
+ @param puzzle size * size cells in row-major order
+ @return hash of the puzzle
+ */
+static uint64_t hashPuzzle(int size, int const *puzzle)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL ^ size;
+    for (int i = 0; i < size * size; i++) {
+        hash = (hash ^ puzzle[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ Finds the entry holding a puzzle. The cache must be locked.
+ @param cache cache to look in
+ @param size dimension of entire grid
+ @param puzzle size * size cells in row-major order
+ @param hash hash of the puzzle
+ @return entry holding the puzzle, or NULL if it isn't in the cache
+ */
+static Entry *findEntry(SolutionCache *cache, int size, int const *puzzle, uint64_t hash)
+{
+    Entry *set = &cache->entries[hash % cache->sets * WAYS];
+    for (int way = 0; way < WAYS; way++) {
+        Entry *entry = &set[way];
+        if (entry->size != size || entry->hash != hash) {
+            continue;
+        }
+        int i = 0;
+        while (i < size * size && entry->cells[i] == puzzle[i]) {
+            i++;
+        }
+        if (i == size * size) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+extern SolutionCache *newCache(long capacity)
+{
+    SolutionCache *cache = malloc(sizeof(SolutionCache));
+    if (!cache) {
+        return NULL;
+    }
+    cache->sets = capacity > WAYS ? (capacity + WAYS - 1) / WAYS : 1;
+    cache->entries = calloc(cache->sets * WAYS, sizeof(Entry));
+    if (!cache->entries) {
+        free(cache);
+        return NULL;
+    }
+    cache->clock = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+extern void freeCache(SolutionCache *cache)
+{
+    if (cache) {
+        for (long i = 0; i < cache->sets * WAYS; i++) {
+            free(cache->entries[i].cells);
+        }
+        free(cache->entries);
+        pthread_mutex_destroy(&cache->lock);
+        free(cache);
+    }
+}
+
+extern CacheResult lookupCache(SolutionCache *cache, int size, int const *puzzle, int *solution)
+{
+    uint64_t hash = hashPuzzle(size, puzzle);
+    CacheResult result = CACHE_MISS;
+    pthread_mutex_lock(&cache->lock);
+    Entry *entry = findEntry(cache, size, puzzle, hash);
+    if (entry) {
+        entry->used = ++cache->clock;
+        if (entry->solved) {
+            for (int i = 0; i < size * size; i++) {
+                solution[i] = entry->cells[size * size + i];
+            }
+        }
+        result = entry->solved ? CACHE_SOLVED : CACHE_NO_SOLUTION;
+        cache->hits++;
+    }
+    else {
+        cache->misses++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return result;
+}
+
+extern void storeCache(SolutionCache *cache, int size, int const *puzzle, int const *solution)
+{
+    uint64_t hash = hashPuzzle(size, puzzle);
+    int cells = size * size;
+    pthread_mutex_lock(&cache->lock);
+    //Another thread may have stored the same puzzle since it was looked up
+    Entry *entry = findEntry(cache, size, puzzle, hash);
+    if (!entry) {
+        Entry *set = &cache->entries[hash % cache->sets * WAYS];
+        entry = &set[0];
+        for (int way = 1; way < WAYS && entry->size != 0; way++) {
+            if (set[way].size == 0 || set[way].used < entry->used) {
+                entry = &set[way];
+            }
+        }
+        unsigned char *buffer = entry->size == size ? entry->cells :
+                                realloc(entry->cells, 2 * cells);
+        if (!buffer) {
+            pthread_mutex_unlock(&cache->lock);
+            return;
+        }
+        entry->cells = buffer;
+        entry->size = size;
+        entry->hash = hash;
+        for (int i = 0; i < cells; i++) {
+            entry->cells[i] = puzzle[i];
+        }
+    }
+    entry->solved = solution != NULL;
+    for (int i = 0; i < cells; i++) {
+        entry->cells[cells + i] = solution ? solution[i] : 0;
+    }
+    entry->used = ++cache->clock;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+extern void cacheCounts(SolutionCache *cache, long *hits, long *misses)
+{
+    pthread_mutex_lock(&cache->lock);
+    *hits = cache->hits;
+    *misses = cache->misses;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ Determines whether a solution read from a file solves its puzzle: every cell is filled in,
+ every given of the puzzle is kept, and no row, column or subgrid repeats a digit
+ @param n dimension of subgrid
+ @param size dimension of entire grid
+ @param puzzle size * size cells of the puzzle in row-major order
+ @param solution size * size cells of the solution in row-major order
+ @return true if the solution solves the puzzle, false otherwise
+ */
+static bool solves(int n, int size, int const *puzzle, int *solution)
+{
+    for (int i = 0; i < size * size; i++) {
+        if (solution[i] == 0 || (puzzle[i] != 0 && puzzle[i] != solution[i])) {
+            return false;
+        }
+    }
+    return validateGrid(n, size, (int (*)[size]) solution);
+}
+
+extern bool loadCache(SolutionCache *cache, char const *fileName)
+{
+    FILE *fp = fopen(fileName, "r");
+    if (!fp) {
+        return true;
+    }
+    int puzzle[MAX_SIZE * MAX_SIZE];
+    int solution[MAX_SIZE * MAX_SIZE];
+    int size;
+    int solved;
+    bool readable = true;
+    while (readable && fscanf(fp, "%d %d", &size, &solved) == 2) {
+        int n = subgridFor(size);
+        readable = n != 0 && (solved == 0 || solved == 1);
+        for (int i = 0; readable && i < size * size * (1 + solved); i++) {
+            int *cell = i < size * size ? &puzzle[i] : &solution[i - size * size];
+            readable = fscanf(fp, "%d", cell) == 1 && *cell >= 0 && *cell <= size;
+        }
+        //Puzzles saved as having no solution can't be checked without solving them again, and
+        //a solution that doesn't solve its puzzle is stale or corrupted, so neither is kept
+        if (readable && solved && solves(n, size, puzzle, solution)) {
+            storeCache(cache, size, puzzle, solution);
+        }
+    }
+    readable = readable && feof(fp);
+    fclose(fp);
+    return readable;
+}
+
+extern bool saveCache(SolutionCache *cache, char const *fileName)
+{
+    FILE *fp = fopen(fileName, "w");
+    if (!fp) {
+        return false;
+    }
+    pthread_mutex_lock(&cache->lock);
+    for (long i = 0; i < cache->sets * WAYS; i++) {
+        Entry const *entry = &cache->entries[i];
+        if (entry->size == 0) {
+            continue;
+        }
+        int cells = entry->size * entry->size;
+        fprintf(fp, "%d %d", entry->size, entry->solved);
+        for (int j = 0; j < (entry->solved ? 2 * cells : cells); j++) {
+            fprintf(fp, " %d", entry->cells[j]);
+        }
+        fprintf(fp, "\n");
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return fclose(fp) == 0;
+}
@@ -0,0 +1,89 @@
+/**
+ @file cache.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the cache component, a bounded map from canonical puzzles to their solutions that
+ can be shared by threads and saved to a file between runs.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdbool.h>
+
+/** Map from canonical puzzles to solutions */
+typedef struct SolutionCache SolutionCache;
+
+/** Result of looking up a puzzle */
+typedef enum {
+    /** Puzzle is not in the cache */
+    CACHE_MISS,
+
+    /** Puzzle is in the cache with a solution */
+    CACHE_SOLVED,
+
+    /** Puzzle is in the cache as having no solution */
+    CACHE_NO_SOLUTION
+} CacheResult;
+
+/**
+ Creates an empty cache
+ @param capacity number of puzzles the cache holds before it starts replacing old ones
+ @return new cache, or NULL if memory ran out
+ */
+SolutionCache *newCache(long capacity);
+
+/**
+ Frees a cache and every puzzle in it
+ @param cache cache to free, or NULL
+ */
+void freeCache(SolutionCache *cache);
+
+/**
+ Looks up a canonical puzzle
+ @param cache cache to look in
+ @param size dimension of entire grid
+ @param puzzle size * size cells of the canonical puzzle in row-major order
+ @param solution filled in with the puzzle's solution in canonical form, if it has one
+ @return CACHE_MISS, CACHE_SOLVED or CACHE_NO_SOLUTION
+ */
+CacheResult lookupCache(SolutionCache *cache, int size, int const *puzzle, int *solution);
+
+/**
+ Adds a canonical puzzle to a cache, replacing the least recently used puzzle that shares its
+ slot if the slot is full
+ @param cache cache to add to
+ @param size dimension of entire grid
+ @param puzzle size * size cells of the canonical puzzle in row-major order
+ @param solution size * size cells of its solution in canonical form, or NULL if it has none
+ */
+void storeCache(SolutionCache *cache, int size, int const *puzzle, int const *solution);
+
+/**
+ Gives the number of lookups that found their puzzle and the number that didn't
+ @param cache cache to look at
+ @param hits filled in with the number of lookups that found their puzzle
+ @param misses filled in with the number that didn't
+ */
+void cacheCounts(SolutionCache *cache, long *hits, long *misses);
+
+/**
+ Adds the puzzles saved in a file to a cache. A missing file is treated as an empty one. Only
+ puzzles saved with a solution that fills in their givens correctly are added; those saved
+ without one, or with a wrong one, are skipped.
+ @param cache cache to add to
+ @param fileName name of the file
+ @return false if the file exists but couldn't be read or has a size that isn't the square of a
+ subgrid dimension, true otherwise
+ */
+bool loadCache(SolutionCache *cache, char const *fileName);
+
+/**
+ Saves every puzzle in a cache to a file, one per line: the size, 1 if the puzzle has a
+ solution or 0 if not, the puzzle's cells and then the solution's cells
+ @param cache cache to save
+ @param fileName name of the file
+ @return false if the file couldn't be written, true otherwise
+ */
+bool saveCache(SolutionCache *cache, char const *fileName);
+
+#endif
@@ -0,0 +1,273 @@
+/**
+ @file canon.c
+ @author Matthew Kierski (mdkiersk)
+ Finds canonical forms of grids. Trying every row and column permutation would take far too
+ long, so rows are first sorted within their band by how many clues they have in each stack, and
+ columns within their stack by how many clues they have in each band. Those counts don't change
+ under any of the transforms, so only rows or columns with equal counts need their orders tried.
+ Digits are relabeled in order of first appearance, and the smallest result is kept.
+ */
+
+#include "canon.h"
+#include <stdbool.h>
+#include <string.h>
+
+/** Largest number of row and column orders tried for one orientation of a grid */
+#define MAX_ORDERS 4096
+
+/** Rows or columns whose orders have to be tried, since they can't be told apart by counts */
+typedef struct {
+    /** First of the rows or columns, in a row or column order */
+    int *items;
+
+    /** Number of rows or columns */
+    int count;
+} Group;
+
+/** A grid seen in one orientation, along with what is needed to order its rows and columns */
+typedef struct {
+    /** Dimension of subgrids */
+    int n;
+
+    /** Dimension of entire grid */
+    int size;
+
+    /** Cells of the grid in row-major order */
+    int const *cells;
+
+    /** True to read the grid transposed */
+    bool transposed;
+} View;
+
+/**
+ Reads a cell of a grid in the view's orientation
+ @param view view of the grid
+ @param row row of the cell in the view
+ @param col column of the cell in the view
+ @return value of the cell
+ */
+static int cellAt(View const *view, int row, int col)
+{
+    if (view->transposed) {
+        return view->cells[col * view->size + row];
+    }
+    return view->cells[row * view->size + col];
+}
+
+/**
+ Computes the clue counts that rows or columns are sorted by: for a row, the number of clues in
+ each stack, and for a column, the number in each band
+ @param view view of the grid
+ @param byRow true for rows, false for columns
+ @param keys filled in with n counts for each of the size rows or columns
+ */
+static void countClues(View const *view, bool byRow, int *keys)
+{
+    int n = view->n;
+    memset(keys, 0, sizeof(int) * view->size * n);
+    for (int r = 0; r < view->size; r++) {
+        for (int c = 0; c < view->size; c++) {
+            if (cellAt(view, r, c) != 0) {
+                keys[byRow ? r * n + c / n : c * n + r / n]++;
+            }
+        }
+    }
+}
+
+/**
+ Sorts the rows or columns of each band or stack by their clue counts, keeping them in index
+ order when the counts are equal, and records the groups whose counts are equal
+ @param n dimension of subgrids
+ @param keys n clue counts for each row or column
+ @param order filled in with the sorted rows or columns
+ @param groups array to add groups of more than one row or column to
+ @param groupCount number of groups in the array, updated
+ @return number of orders the groups allow, or MAX_ORDERS + 1 if there are more than MAX_ORDERS
+ */
+static long sortByClues(int n, int const *keys, int *order, Group *groups, int *groupCount)
+{
+    long orders = 1;
+    for (int first = 0; first < n * n; first += n) {
+        //Insertion sort, since a band only holds n rows
+        for (int i = first; i < first + n; i++) {
+            int item = i;
+            int j = i;
+            while (j > first && memcmp(&keys[order[j - 1] * n], &keys[item * n],
+                                       sizeof(int) * n) > 0) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = item;
+        }
+        for (int i = first; i < first + n;) {
+            int count = 1;
+            while (i + count < first + n &&
+                   memcmp(&keys[order[i] * n], &keys[order[i + count] * n], sizeof(int) * n) == 0) {
+                count++;
+            }
+            if (count > 1) {
+                groups[(*groupCount)++] = (Group) { &order[i], count };
+                for (int k = 2; k <= count && orders <= MAX_ORDERS; k++) {
+                    orders *= k;
+                }
+            }
+            i += count;
+        }
+    }
+    return orders <= MAX_ORDERS ? orders : MAX_ORDERS + 1;
+}
+
+/**
+ Rearranges values into the next permutation in lexicographic order
+ @param values values to rearrange
+ @param count number of values
+ @return false if the values were in the last permutation and have wrapped around to the
+ first, true otherwise
+ */
+static bool nextPermutation(int *values, int count)
+{
+    int i = count - 2;
+    while (i >= 0 && values[i] >= values[i + 1]) {
+        i--;
+    }
+    if (i >= 0) {
+        int j = count - 1;
+        while (values[j] <= values[i]) {
+            j--;
+        }
+        int temp = values[i];
+        values[i] = values[j];
+        values[j] = temp;
+    }
+    for (int lo = i + 1, hi = count - 1; lo < hi; lo++, hi--) {
+        int temp = values[lo];
+        values[lo] = values[hi];
+        values[hi] = temp;
+    }
+    return i >= 0;
+}
+
+/**
+ Relabels a view through a row and column order and compares the result with the best form
+ found so far, replacing it if the new form is smaller
+ @param view view of the grid
+ @param rows row order
+ @param cols column order
+ @param found true if best holds a form already
+ @param best smallest form found so far, in row-major order
+ @param digits label of each digit in best, replaced along with it
+ @return true if best was replaced, false otherwise
+ */
+static bool tryOrder(View const *view, int const *rows, int const *cols, bool found, int *best,
+                     int *digits)
+{
+    int size = view->size;
+    int labels[MAX_SIZE + 1] = { 0 };
+    int next = 1;
+    bool smaller = !found;
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            int value = cellAt(view, rows[r], cols[c]);
+            if (value != 0) {
+                if (labels[value] == 0) {
+                    labels[value] = next++;
+                }
+                value = labels[value];
+            }
+            int *cell = &best[r * size + c];
+            if (!smaller) {
+                //Stop as soon as the form is known not to be smaller
+                if (value > *cell) {
+                    return false;
+                }
+                smaller = value < *cell;
+            }
+            *cell = value;
+        }
+    }
+    if (smaller) {
+        memcpy(digits, labels, sizeof(labels));
+    }
+    return smaller;
+}
+
+extern bool canonicalForm(int n, int size, int grid[size][size], int canon[size][size],
+                          Transform *transform)
+{
+    int rowKeys[MAX_SIZE * MAX_SUBGRID];
+    int colKeys[MAX_SIZE * MAX_SUBGRID];
+    int rows[MAX_SIZE];
+    int cols[MAX_SIZE];
+    Group groups[MAX_SIZE];
+    bool found = false;
+    for (int t = 0; t < 2; t++) {
+        View view = { n, size, &grid[0][0], t == 1 };
+        countClues(&view, true, rowKeys);
+        countClues(&view, false, colKeys);
+        int groupCount = 0;
+        long orders = sortByClues(n, rowKeys, rows, groups, &groupCount) *
+                      sortByClues(n, colKeys, cols, groups, &groupCount);
+        //The counts are the same for every equivalent grid, so rejecting here is consistent
+        if (orders > MAX_ORDERS) {
+            return false;
+        }
+
+        //Try every order of each group, like an odometer whose digits are the groups
+        bool more = true;
+        while (more) {
+            if (tryOrder(&view, rows, cols, found, &canon[0][0], transform->digits)) {
+                found = true;
+                transform->transposed = view.transposed;
+                memcpy(transform->rows, rows, sizeof(int) * size);
+                memcpy(transform->cols, cols, sizeof(int) * size);
+            }
+            int g = 0;
+            while (g < groupCount && !nextPermutation(groups[g].items, groups[g].count)) {
+                g++;
+            }
+            more = g < groupCount;
+        }
+    }
+
+    //Digits missing from the grid get the remaining labels, so the transform covers solutions
+    int next = 1;
+    for (int digit = 1; digit <= size; digit++) {
+        next += transform->digits[digit] != 0;
+    }
+    for (int digit = 1; digit <= size; digit++) {
+        if (transform->digits[digit] == 0) {
+            transform->digits[digit] = next++;
+        }
+    }
+    return true;
+}
+
+extern void applyTransform(int size, Transform const *transform, int grid[size][size],
+                           int out[size][size])
+{
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            int row = transform->rows[r];
+            int col = transform->cols[c];
+            int value = transform->transposed ? grid[col][row] : grid[row][col];
+            out[r][c] = transform->digits[value];
+        }
+    }
+}
+
+extern void undoTransform(int size, Transform const *transform, int canon[size][size],
+                          int grid[size][size])
+{
+    int inverse[MAX_SIZE + 1] = { 0 };
+    for (int digit = 1; digit <= size; digit++) {
+        inverse[transform->digits[digit]] = digit;
+    }
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            int row = transform->rows[r];
+            int col = transform->cols[c];
+            int *cell = transform->transposed ? &grid[col][row] : &grid[row][col];
+            *cell = inverse[canon[r][c]];
+        }
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ @file canon.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the canon component, which puts puzzles into a canonical form. Two puzzles that
+ differ only by relabeling digits, permuting rows within bands, permuting columns within stacks
+ and transposing have the same canonical form, and the transform found for each puzzle maps a
+ solution of the canonical form back to a solution of the puzzle.
+ */
+
+#ifndef CANON_H
+#define CANON_H
+
+#include "solve.h"
+#include <stdbool.h>
+
+/** Dimension of the largest supported grid */
+#define MAX_SIZE (MAX_SUBGRID * MAX_SUBGRID)
+
+/** A transform taking a grid to its canonical form */
+typedef struct {
+    /** True if the grid is transposed before rows and columns are permuted */
+    bool transposed;
+
+    /** Row of the (transposed) grid that each row of the canonical form comes from */
+    int rows[MAX_SIZE];
+
+    /** Column of the (transposed) grid that each column of the canonical form comes from */
+    int cols[MAX_SIZE];
+
+    /** Label in the canonical form of each digit, indexed by digit; 0 stays 0 */
+    int digits[MAX_SIZE + 1];
+} Transform;
+
+/**
+ Finds the canonical form of an incomplete grid and the transform that produces it. The
+ canonical form is the smallest grid, in row-major order, that the grid can be transformed
+ into while its rows and columns stay sorted by how their clues fall into stacks and bands.
+ Grids whose clues leave too many such orders to try, such as nearly complete ones, are
+ rejected, and so are all grids equivalent to them.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing the grid
+ @param canon filled in with the canonical form
+ @param transform filled in with the transform from grid to canon
+ @return false if the grid was rejected, true otherwise
+ */
+bool canonicalForm(int n, int size, int grid[size][size], int canon[size][size],
+                   Transform *transform);
+
+/**
+ Applies a transform to a grid, such as a solution of the grid the transform was found for
+ @param size dimension of entire grid
+ @param transform transform to apply
+ @param grid 2D array to transform
+ @param out filled in with the transformed grid
+ */
+void applyTransform(int size, Transform const *transform, int grid[size][size],
+                    int out[size][size]);
+
+/**
+ Undoes a transform, such as to map a solution of a canonical form back to the original grid
+ @param size dimension of entire grid
+ @param transform transform to undo
+ @param canon 2D array in the transformed form
+ @param grid filled in with the grid canon was transformed from
+ */
+void undoTransform(int size, Transform const *transform, int canon[size][size],
+                   int grid[size][size]);
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ @file dlx.c
+ @author Matthew Kierski (mdkiersk)
+ Solves grids with Algorithm X over a dancing links matrix. Every (cell, digit) choice is a
+ row of the matrix, and it covers four columns: the cell itself, and the digit within its
+ row, its column and its subgrid. A solution is a set of rows covering every column once.
+ */
+
+#include "dlx.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+/** Number of constraints every choice satisfies: cell, row, column and subgrid */
+#define CONSTRAINTS 4
+
+/** Index of the root header node */
+#define ROOT 0
+
+/** Node pool holding the links of the whole matrix, stored as parallel arrays */
+typedef struct {
+    /** Left neighbor of each node */
+    int *left;
+
+    /** Right neighbor of each node */
+    int *right;
+
+    /** Node above each node */
+    int *up;
+
+    /** Node below each node */
+    int *down;
+
+    /** Column header each node belongs to */
+    int *column;
+
+    /** Matrix row (cell * size + digit - 1) each node belongs to */
+    int *row;
+
+    /** Number of nodes currently in each column, indexed by header node */
+    int *count;
+} Links;
+
+/**
+ Removes a column from the header list, along with every row that intersects it
+ @param x matrix links
+ @param col header node of the column
+ */
+static void cover(Links *x, int col)
+{
+    x->right[x->left[col]] = x->right[col];
+    x->left[x->right[col]] = x->left[col];
+    for (int i = x->down[col]; i != col; i = x->down[i]) {
+        for (int j = x->right[i]; j != i; j = x->right[j]) {
+            x->down[x->up[j]] = x->down[j];
+            x->up[x->down[j]] = x->up[j];
+            x->count[x->column[j]]--;
+        }
+    }
+}
+
+/**
+ Puts back a column removed by cover, in exactly the reverse order
+ @param x matrix links
+ @param col header node of the column
+ */
+static void uncover(Links *x, int col)
+{
+    for (int i = x->up[col]; i != col; i = x->up[i]) {
+        for (int j = x->left[i]; j != i; j = x->left[j]) {
+            x->count[x->column[j]]++;
+            x->down[x->up[j]] = j;
+            x->up[x->down[j]] = j;
+        }
+    }
+    x->right[x->left[col]] = col;
+    x->left[x->right[col]] = col;
+}
+
+/**
+ Chooses the uncovered column with the fewest rows left, preferring the first one
+ @param x matrix links
+ @return header node of the column
+ */
+static int pickColumn(Links *x)
+{
+    int best = x->right[ROOT];
+    for (int col = x->right[best]; col != ROOT; col = x->right[col]) {
+        if (x->count[col] < x->count[best]) {
+            best = col;
+            if (x->count[best] <= 1) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ Links up the full exact cover matrix for a grid of the given dimensions
+ @param x matrix links, with arrays large enough for every node
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ */
+static void buildMatrix(Links *x, int n, int size)
+{
+    int cells = size * size;
+    int columns = CONSTRAINTS * cells;
+
+    //Header nodes form a circular list with the root
+    for (int col = 0; col <= columns; col++) {
+        x->left[col] = col == 0 ? columns : col - 1;
+        x->right[col] = col == columns ? 0 : col + 1;
+        x->up[col] = x->down[col] = col;
+        x->column[col] = col;
+        x->count[col] = 0;
+    }
+
+    int node = columns + 1;
+    for (int cell = 0; cell < cells; cell++) {
+        int r = cell / size;
+        int c = cell % size;
+        int box = (r / n) * n + c / n;
+        for (int d = 0; d < size; d++) {
+            int headers[CONSTRAINTS] = {
+                1 + cell,
+                1 + cells + r * size + d,
+                1 + 2 * cells + c * size + d,
+                1 + 3 * cells + box * size + d
+            };
+            for (int k = 0; k < CONSTRAINTS; k++) {
+                int col = headers[k];
+                x->column[node + k] = col;
+                x->row[node + k] = cell * size + d;
+                x->left[node + k] = node + (k + CONSTRAINTS - 1) % CONSTRAINTS;
+                x->right[node + k] = node + (k + 1) % CONSTRAINTS;
+                x->up[node + k] = x->up[col];
+                x->down[node + k] = col;
+                x->down[x->up[col]] = node + k;
+                x->up[col] = node + k;
+                x->count[col]++;
+            }
+            node += CONSTRAINTS;
+        }
+    }
+}
+
+/**
+ Searches the matrix for an exact cover without recursion, recording the chosen rows
+ @param x matrix links, with the givens already covered
+ @param choice stack of chosen row nodes, one per level of the search
+ @param levels filled in with the number of rows in the cover
+ @param stats counters to add this search's work to
+ @return true if a cover was found, false otherwise
+ */
+static bool search(Links *x, int choice[], int *levels, SolveStats *stats)
+{
+    int level = 0;
+    while (true) {
+        //Go deeper: choose a column and start on its first row
+        if (x->right[ROOT] == ROOT) {
+            *levels = level;
+            return true;
+        }
+        int col = pickColumn(x);
+        cover(x, col);
+        choice[level] = x->down[col];
+
+        //Try rows until one is placed, backing up through earlier levels as needed
+        while (true) {
+            int r = choice[level];
+            if (r != col) {
+                stats->nodes++;
+                for (int j = x->right[r]; j != r; j = x->right[j]) {
+                    cover(x, x->column[j]);
+                }
+                level++;
+                if (level > stats->maxDepth) {
+                    stats->maxDepth = level;
+                }
+                break;
+            }
+            uncover(x, col);
+            if (level == 0) {
+                return false;
+            }
+            level--;
+            stats->backtracks++;
+            r = choice[level];
+            col = x->column[r];
+            for (int j = x->left[r]; j != r; j = x->left[j]) {
+                uncover(x, x->column[j]);
+            }
+            choice[level] = x->down[r];
+        }
+    }
+}
+
+extern bool solveDlx(int n, int size, int grid[size][size], SolveStats *stats)
+{
+    int cells = size * size;
+    int columns = CONSTRAINTS * cells;
+    int nodes = columns + 1 + CONSTRAINTS * cells * size;
+
+    //One allocation holds every link, so the search itself never allocates
+    int *pool = malloc(sizeof(int) * (6 * nodes + columns + 1 + cells));
+    if (!pool) {
+        return false;
+    }
+    Links x = { pool, pool + nodes, pool + 2 * nodes, pool + 3 * nodes, pool + 4 * nodes,
+                pool + 5 * nodes, pool + 6 * nodes };
+    int *choice = pool + 6 * nodes + columns + 1;
+    buildMatrix(&x, n, size);
+
+    //Select the row for every given, failing if two givens need the same column
+    bool solved = true;
+    for (int cell = 0; cell < cells && solved; cell++) {
+        int digit = grid[cell / size][cell % size];
+        if (digit == 0) {
+            continue;
+        }
+        int r = columns + 1 + CONSTRAINTS * (cell * size + digit - 1);
+        for (int k = 0; k < CONSTRAINTS && solved; k++) {
+            int col = x.column[r + k];
+            //A covered column has been unlinked, so its neighbor no longer points back at it
+            if (x.left[x.right[col]] != col) {
+                solved = false;
+            }
+            else {
+                cover(&x, col);
+            }
+        }
+    }
+
+    int levels = 0;
+    if (solved && search(&x, choice, &levels, stats)) {
+        for (int i = 0; i < levels; i++) {
+            int row = x.row[choice[i]];
+            grid[row / size / size][row / size % size] = row % size + 1;
+        }
+    }
+    else {
+        solved = false;
+    }
+    free(pool);
+    return solved;
+}
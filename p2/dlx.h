@@ -0,0 +1,25 @@
+/**
+ @file dlx.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the dlx component, which solves grids as an exact cover problem using Knuth's
+ Algorithm X with dancing links.
+ */
+
+#ifndef DLX_H
+#define DLX_H
+
+#include "solve.h"
+#include <stdbool.h>
+
+/**
+ Attempts to solve a grid as an exact cover problem with dancing links. All links are kept in
+ one node pool sized from the grid dimension and allocated before the search starts.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, filled in with the solution if one is found
+ @param stats counters to add this search's work to
+ @return true if solved, false otherwise
+ */
+bool solveDlx(int n, int size, int grid[size][size], SolveStats *stats);
+
+#endif
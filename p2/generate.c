@@ -0,0 +1,173 @@
+/**
+ @file generate.c
+ @author Matthew Kierski (mdkiersk)
+ Makes puzzles with a unique solution. A solved grid is built from randomly filled diagonal
+ subgrids, which never constrain each other, and then thinned out with the solver checking
+ uniqueness after every removal. Random choices come from a small seedable generator kept per
+ puzzle, so puzzles can be made on any thread and still come out the same.
+ */
+
+#include "generate.h"
+#include "solve.h"
+#include "pool.h"
+#include "util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Number of solved grids to try thinning out before giving up on a clue count */
+#define MAX_ATTEMPTS 50
+
+/** Number of puzzles generated together before they are printed */
+#define CHUNK_PUZZLES 64
+
+/** Puzzles being generated together */
+typedef struct {
+    /** Dimension of subgrids */
+    int n;
+
+    /** Number of clues to leave in each puzzle */
+    int clues;
+
+    /** Seed for the whole set of puzzles */
+    unsigned long seed;
+
+    /** Position of the chunk's first puzzle in the whole set */
+    long first;
+
+    /** Grids of the puzzles in this chunk, each n^4 cells */
+    int *grids;
+
+    /** Whether each puzzle was made with the requested number of clues */
+    bool *made;
+} Chunk;
+
+/**
+ Shuffles values in place so that every order is equally likely
+ @param values values to shuffle
+ @param count number of values
+ @param state state of the random number generator
+ */
+static void shuffle(int *values, int count, uint64_t *state)
+{
+    for (int i = count - 1; i > 0; i--) {
+        int j = nextRandom(state) % (i + 1);
+        int temp = values[i];
+        values[i] = values[j];
+        values[j] = temp;
+    }
+}
+
+/**
+ Fills a grid with a random solution by putting random permutations of the digits in the
+ subgrids on the diagonal and letting the solver complete the rest
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array filled in with the solution
+ @param state state of the random number generator
+ @return true if the grid was filled, false otherwise
+ */
+static bool randomSolution(int n, int size, int grid[size][size], uint64_t *state)
+{
+    int digits[size];
+    for (int i = 0; i < size; i++) {
+        digits[i] = i + 1;
+    }
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            grid[row][col] = 0;
+        }
+    }
+    for (int box = 0; box < n; box++) {
+        shuffle(digits, size, state);
+        for (int i = 0; i < size; i++) {
+            grid[box * n + i / n][box * n + i % n] = digits[i];
+        }
+    }
+    return solve(n, size, grid);
+}
+
+extern bool generatePuzzle(int n, int size, int grid[size][size], int clues, unsigned long seed)
+{
+    uint64_t state = seed;
+    int order[size * size];
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        if (!randomSolution(n, size, grid, &state)) {
+            continue;
+        }
+        //Remove clues in random order, keeping those the puzzle can't be unique without
+        int left = size * size;
+        for (int i = 0; i < size * size; i++) {
+            order[i] = i;
+        }
+        shuffle(order, size * size, &state);
+        for (int i = 0; i < size * size && left > clues; i++) {
+            int *cell = &grid[order[i] / size][order[i] % size];
+            int value = *cell;
+            *cell = 0;
+            if (countSolutions(n, size, grid, 2, NULL, 1) == 1) {
+                left--;
+            }
+            else {
+                *cell = value;
+            }
+        }
+        if (left <= clues || clues == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ Pool job that generates one puzzle of a chunk
+ @param context the chunk being generated
+ @param index index of the puzzle within the chunk
+ */
+static void generateJob(void *context, int index)
+{
+    Chunk *chunk = context;
+    int size = chunk->n * chunk->n;
+    int (*grid)[size] = (int (*)[size]) (chunk->grids + (long) index * size * size);
+    //Spread neighboring positions out so every puzzle gets an unrelated stream
+    uint64_t state = chunk->seed * 0x9E3779B97F4A7C15ULL + chunk->first + index;
+    uint64_t seed = nextRandom(&state);
+    chunk->made[index] = generatePuzzle(chunk->n, size, grid, chunk->clues, seed);
+}
+
+extern bool generatePuzzles(int n, int clues, unsigned long seed, long count, int threads,
+                            FILE *out)
+{
+    int size = n * n;
+    Chunk chunk = { n, clues, seed, 0, malloc(sizeof(int) * size * size * CHUNK_PUZZLES),
+                    malloc(sizeof(bool) * CHUNK_PUZZLES) };
+    bool allMade = chunk.grids && chunk.made;
+    if (!allMade) {
+        fprintf(stderr, "Out of memory\n");
+    }
+    while (allMade && chunk.first < count) {
+        int jobs = count - chunk.first < CHUNK_PUZZLES ? count - chunk.first : CHUNK_PUZZLES;
+        runPool(threads, jobs, generateJob, &chunk);
+
+        for (int i = 0; i < jobs; i++) {
+            if (!chunk.made[i]) {
+                fprintf(stderr, "Can't generate a puzzle with %d clues\n", clues);
+                allMade = false;
+                break;
+            }
+            int *grid = chunk.grids + (long) i * size * size;
+            fprintf(out, "%d\n", size);
+            for (int row = 0; row < size; row++) {
+                for (int col = 0; col < size; col++) {
+                    fprintf(out, col == 0 ? "%d" : " %d", grid[row * size + col]);
+                }
+                fprintf(out, "\n");
+            }
+        }
+        chunk.first += jobs;
+    }
+    free(chunk.grids);
+    free(chunk.made);
+    return allMade;
+}
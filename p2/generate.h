@@ -0,0 +1,44 @@
+/**
+ @file generate.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the generate component, which makes new puzzles with a unique solution by removing
+ clues from a random solved grid.
+ */
+
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**
+ Generates a puzzle with a unique solution. A random solved grid is made first, then clues are
+ removed in random order, putting back any whose removal lets the puzzle have more than one
+ solution, until only the requested number of clues is left. If the clues run out first, it
+ starts over from a new solved grid, giving up after a fixed number of attempts. The same seed
+ always gives the same puzzle.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array filled in with the puzzle, 0 for empty cells
+ @param clues number of clues to leave, or 0 to remove as many as possible
+ @param seed seed for the random choices
+ @return true if a puzzle with the requested number of clues was made, false otherwise
+ */
+bool generatePuzzle(int n, int size, int grid[size][size], int clues, unsigned long seed);
+
+/**
+ Generates several puzzles on a pool of worker threads and prints them in order, each as its
+ size followed by its grid. Every puzzle is seeded from the seed and its position alone, so the
+ output is the same for any number of threads.
+ @param n dimension of subgrids
+ @param clues number of clues to leave in each puzzle, or 0 to remove as many as possible
+ @param seed seed for the whole set of puzzles
+ @param count number of puzzles to generate
+ @param threads number of worker threads to use
+ @param out stream to print the puzzles to
+ @return true if every puzzle was made with the requested number of clues, false if
+ generation stopped at one that couldn't be or memory ran out
+ */
+bool generatePuzzles(int n, int clues, unsigned long seed, long count, int threads, FILE *out);
+
+#endif
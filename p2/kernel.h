@@ -0,0 +1,936 @@
+/**
+ @file kernel.h
+ @author Matthew Kierski (mdkiersk)
+ Search kernel for the propagate engine, written once and compiled separately for every
+ subgrid dimension. Before including this file, define KERNEL_N as the subgrid dimension and
+ KERNEL_MASK as an unsigned integer type with at least KERNEL_N * KERNEL_N bits. The grid
+ dimensions are then compile-time constants, so small grids get narrow masks and loops the
+ compiler can unroll. Including the file defines the SearchN type, the solvePropagateN,
+ solveParallelN, countSolutionsN and countParallelN functions, and newSearchN, beginN, stepN and
+ storeN for running a search a step at a time (for example, solvePropagate3 and Search3), and
+ undefines both macros again.
+
+ The kernel keeps a candidate mask for every cell and narrows those masks with naked singles,
+ hidden singles and box/line reduction. When nothing more can be deduced, it branches on the
+ cell with the fewest candidates, undoing changes through a trail on failure.
+
+ There is deliberately no include guard.
+ */
+
+#include "solve.h"
+#include "propagate.h"
+#include "pool.h"
+#include "steal.h"
+#include "layout.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <sched.h>
+
+#ifndef KERNEL_PHASE
+#define KERNEL_PHASE
+
+/** What a search does when it next resumes, shared by every kernel */
+typedef enum {
+    /** Pick a cell to branch on, or report a solution if every cell is filled */
+    PHASE_PICK,
+
+    /** Try the first digit of the branch just made */
+    PHASE_FRESH,
+
+    /** Take back the last digit tried and try the next one */
+    PHASE_RETRY,
+
+    /** The search space has been used up */
+    PHASE_DONE
+} Phase;
+
+#endif
+
+/** Pastes a name and a number together, after expanding the number */
+#define KERNEL_PASTE(name, n) KERNEL_PASTE2(name, n)
+/** Pastes a name and a number together */
+#define KERNEL_PASTE2(name, n) name##n
+/** Gives a name specific to this kernel's subgrid dimension */
+#define K(name) KERNEL_PASTE(name, KERNEL_N)
+
+/** Subgrid dimension */
+#define N KERNEL_N
+/** Dimension of entire grid */
+#define SIZE (N * N)
+/** Number of cells in the grid */
+#define CELLS (SIZE * SIZE)
+/** Number of kinds of unit: rows, columns and subgrids */
+#define UNIT_KINDS 3
+/** Mask type for this kernel */
+#define KMask KERNEL_MASK
+/** Mask holding every digit */
+#define FULL ((KMask) ((((unsigned long long) 1) << (SIZE - 1) << 1) - 1))
+
+/** Working state for one propagation search, allocated on the heap as a single block */
+typedef struct {
+    /** Remaining candidates for each cell, in row-major order */
+    KMask cand[CELLS];
+
+    /** UNIT_KINDS * SIZE units (rows, then columns, then subgrids), each listing SIZE cells,
+     from the layout shared by every grid of this size */
+    uint16_t const *units;
+
+    /** Cells whose candidates were narrowed, most recent last */
+    int trailCell[CELLS * SIZE];
+
+    /** Candidates each trail cell had before it was narrowed */
+    KMask trailMask[CELLS * SIZE];
+
+    /** Number of entries on the trail */
+    int trailLen;
+
+    /** Cells that have been narrowed to one digit but not yet removed from their peers */
+    int queue[CELLS];
+
+    /** Number of cells in the queue */
+    int queueLen;
+
+    /** Cell branched on at each depth of the search */
+    int frameCell[CELLS + 1];
+
+    /** Trail length before each branch was tried */
+    int frameMark[CELLS + 1];
+
+    /** Digits not yet tried at each depth */
+    KMask frameLeft[CELLS + 1];
+
+    /** Number of branches currently taken */
+    int depth;
+
+    /** Number of branches taken to reach the state the search started from */
+    int baseDepth;
+
+    /** What the search does when it next resumes */
+    Phase phase;
+
+    /** Number of nodes the search may still visit before pausing */
+    long budget;
+
+    /** Counters for this search */
+    SolveStats *stats;
+
+    /** Flag that stops the search once set by another thread, or NULL */
+    bool *cancel;
+} K(Search);
+
+/**
+ Returns the smallest digit in a mask, as a mask
+ @param mask nonempty set of digits
+ @return mask holding only the smallest digit
+ */
+static inline KMask K(lowest)(KMask mask)
+{
+    return mask & (KMask) -mask;
+}
+
+/**
+ Checks whether a mask holds exactly one digit
+ @param mask set of digits
+ @return true if the mask has a single bit set
+ */
+static inline bool K(single)(KMask mask)
+{
+    return mask != 0 && (mask & (mask - 1)) == 0;
+}
+
+/**
+ Finds the units a cell belongs to
+ @param cell cell index in row-major order
+ @param unitsOf filled in with the cell's row, column and subgrid unit numbers
+ */
+static inline void K(cellUnits)(int cell, int unitsOf[UNIT_KINDS])
+{
+    int row = cell / SIZE;
+    int col = cell % SIZE;
+    unitsOf[0] = row;
+    unitsOf[1] = SIZE + col;
+    unitsOf[2] = SIZE + SIZE + (row / N) * N + col / N;
+}
+
+/**
+ Removes digits from a cell's candidates, recording the old candidates on the trail
+ @param s search state
+ @param cell cell to narrow
+ @param bits digits to remove
+ @return false if the cell is left with no candidates, true otherwise
+ */
+static inline bool K(eliminate)(K(Search) *s, int cell, KMask bits)
+{
+    KMask old = s->cand[cell];
+    if ((old & bits) == 0) {
+        return true;
+    }
+    s->trailCell[s->trailLen] = cell;
+    s->trailMask[s->trailLen] = old;
+    s->trailLen++;
+    KMask now = old & ~bits;
+    s->cand[cell] = now;
+    if (now == 0) {
+        return false;
+    }
+    if (K(single)(now)) {
+        s->queue[s->queueLen++] = cell;
+    }
+    return true;
+}
+
+/**
+ Places a digit in a cell by removing every other candidate
+ @param s search state
+ @param cell cell to fill
+ @param bit digit to place, as a mask
+ @return false if the digit is not a candidate for the cell, true otherwise
+ */
+static inline bool K(assign)(K(Search) *s, int cell, KMask bit)
+{
+    return K(eliminate)(s, cell, s->cand[cell] & ~bit);
+}
+
+/**
+ Restores every cell narrowed since the trail had the given length
+ @param s search state
+ @param mark trail length to return to
+ */
+static void K(undo)(K(Search) *s, int mark)
+{
+    while (s->trailLen > mark) {
+        s->trailLen--;
+        s->cand[s->trailCell[s->trailLen]] = s->trailMask[s->trailLen];
+    }
+    s->queueLen = 0;
+}
+
+/**
+ Removes the digit of every queued single from the other cells in its units
+ @param s search state
+ @return false if a contradiction was found, true otherwise
+ */
+static bool K(nakedSingles)(K(Search) *s)
+{
+    for (int head = 0; head < s->queueLen; head++) {
+        int cell = s->queue[head];
+        KMask bit = s->cand[cell];
+        s->stats->propagations++;
+        int unitsOf[UNIT_KINDS];
+        K(cellUnits)(cell, unitsOf);
+        for (int k = 0; k < UNIT_KINDS; k++) {
+            uint16_t const *members = s->units + unitsOf[k] * SIZE;
+            for (int i = 0; i < SIZE; i++) {
+                if (members[i] != cell && !K(eliminate)(s, members[i], bit)) {
+                    s->queueLen = 0;
+                    return false;
+                }
+            }
+        }
+    }
+    s->queueLen = 0;
+    return true;
+}
+
+/**
+ Places every digit that has only one possible cell left in some unit
+ @param s search state
+ @return number of digits placed, or -1 if a unit has no place left for some digit
+ */
+static int K(hiddenSingles)(K(Search) *s)
+{
+    int placed = 0;
+    for (int u = 0; u < UNIT_KINDS * SIZE; u++) {
+        uint16_t const *members = s->units + u * SIZE;
+        KMask once = 0;
+        KMask twice = 0;
+        for (int i = 0; i < SIZE; i++) {
+            KMask m = s->cand[members[i]];
+            twice |= once & m;
+            once |= m;
+        }
+        if (once != FULL) {
+            return -1;
+        }
+        for (KMask hidden = once & ~twice; hidden; hidden &= hidden - 1) {
+            KMask bit = K(lowest)(hidden);
+            for (int i = 0; i < SIZE; i++) {
+                KMask m = s->cand[members[i]];
+                if (m & bit) {
+                    if (m != bit) {
+                        if (!K(assign)(s, members[i], bit)) {
+                            return -1;
+                        }
+                        placed++;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    return placed;
+}
+
+/**
+ Removes digits from the cells of a line that lie outside one subgrid
+ @param s search state
+ @param first first cell of the line
+ @param step distance between consecutive cells of the line
+ @param skipFrom position along the line where the subgrid starts
+ @param bits digits to remove
+ @return false if a contradiction was found, true otherwise
+ */
+static bool K(eliminateOutside)(K(Search) *s, int first, int step, int skipFrom, KMask bits)
+{
+    if (bits == 0) {
+        return true;
+    }
+    for (int i = 0; i < SIZE; i++) {
+        if ((i < skipFrom || i >= skipFrom + N) && !K(eliminate)(s, first + i * step, bits)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ Applies box/line reduction. When a digit's candidates in a subgrid all lie on one row or
+ column, it is removed from the rest of that line, and when a digit's candidates on a line
+ all lie in one subgrid, it is removed from the rest of that subgrid.
+ @param s search state
+ @return number of candidates removed, or -1 if a contradiction was found
+ */
+static int K(boxLineReduction)(K(Search) *s)
+{
+    int mark = s->trailLen;
+    for (int top = 0; top < SIZE; top += N) {
+        for (int left = 0; left < SIZE; left += N) {
+            //Candidates in each row and each column of this subgrid
+            KMask rowOr[N] = { 0 };
+            KMask colOr[N] = { 0 };
+            for (int i = 0; i < N; i++) {
+                for (int j = 0; j < N; j++) {
+                    KMask m = s->cand[(top + i) * SIZE + left + j];
+                    rowOr[i] |= m;
+                    colOr[j] |= m;
+                }
+            }
+            for (int i = 0; i < N; i++) {
+                KMask rowOthers = 0;
+                KMask colOthers = 0;
+                for (int j = 0; j < N; j++) {
+                    if (j != i) {
+                        rowOthers |= rowOr[j];
+                        colOthers |= colOr[j];
+                    }
+                }
+                //Pointing: the digit is confined to this row (or column) within the subgrid
+                if (!K(eliminateOutside)(s, (top + i) * SIZE, 1, left, rowOr[i] & ~rowOthers) ||
+                    !K(eliminateOutside)(s, left + i, SIZE, top, colOr[i] & ~colOthers)) {
+                    return -1;
+                }
+            }
+        }
+    }
+    for (int line = 0; line < SIZE; line++) {
+        //Candidates in each subgrid-wide segment of this row and of this column
+        KMask rowSeg[N] = { 0 };
+        KMask colSeg[N] = { 0 };
+        for (int k = 0; k < N; k++) {
+            for (int i = k * N; i < k * N + N; i++) {
+                rowSeg[k] |= s->cand[line * SIZE + i];
+                colSeg[k] |= s->cand[i * SIZE + line];
+            }
+        }
+        int band = line - line % N;
+        for (int k = 0; k < N; k++) {
+            KMask rowOthers = 0;
+            KMask colOthers = 0;
+            for (int j = 0; j < N; j++) {
+                if (j != k) {
+                    rowOthers |= rowSeg[j];
+                    colOthers |= colSeg[j];
+                }
+            }
+            //Claiming: the digit is confined to one subgrid along this line
+            KMask rowOnly = rowSeg[k] & ~rowOthers;
+            KMask colOnly = colSeg[k] & ~colOthers;
+            if ((rowOnly | colOnly) == 0) {
+                continue;
+            }
+            for (int i = band; i < band + N; i++) {
+                if (i == line) {
+                    continue;
+                }
+                for (int j = k * N; j < k * N + N; j++) {
+                    if (!K(eliminate)(s, i * SIZE + j, rowOnly) ||
+                        !K(eliminate)(s, j * SIZE + i, colOnly)) {
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+    return s->trailLen - mark;
+}
+
+/**
+ Applies every deduction rule until none of them makes progress
+ @param s search state
+ @return false if a contradiction was found, true otherwise
+ */
+static bool K(propagate)(K(Search) *s)
+{
+    while (true) {
+        if (!K(nakedSingles)(s)) {
+            return false;
+        }
+        int found = K(hiddenSingles)(s);
+        if (found < 0) {
+            return false;
+        }
+        if (found > 0) {
+            continue;
+        }
+        found = K(boxLineReduction)(s);
+        if (found < 0) {
+            s->queueLen = 0;
+            return false;
+        }
+        if (found == 0) {
+            return true;
+        }
+    }
+}
+
+/**
+ Chooses the unsolved cell with the fewest candidates, preferring the first in row-major order
+ @param s search state
+ @return cell to branch on, or -1 if every cell is solved
+ */
+static int K(pickCell)(K(Search) *s)
+{
+    int best = -1;
+    int bestCount = SIZE + 1;
+    for (int cell = 0; cell < CELLS; cell++) {
+        int count = __builtin_popcountll(s->cand[cell]);
+        if (count > 1 && count < bestCount) {
+            best = cell;
+            bestCount = count;
+            if (count == 2) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ Allocates search state with nothing loaded into it yet
+ @param stats counters to add the search's work to
+ @param cancel flag that stops the search once set by another thread, or NULL
+ @return newly allocated search state, or NULL if it couldn't be allocated
+ */
+static K(Search) *K(newSearch)(SolveStats *stats, bool *cancel)
+{
+    K(Search) *s = malloc(sizeof(K(Search)));
+    if (s) {
+        s->trailLen = 0;
+        s->queueLen = 0;
+        s->baseDepth = 0;
+        s->stats = stats;
+        s->cancel = cancel;
+        s->units = layoutFor(N)->units;
+    }
+    return s;
+}
+
+/**
+ Loads a grid's givens into search state and deduces what it can from them
+ @param s search state
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty
+ @return false if the givens lead to a contradiction, true otherwise
+ */
+static bool K(load)(K(Search) *s, int const *grid)
+{
+    s->trailLen = 0;
+    s->queueLen = 0;
+    for (int cell = 0; cell < CELLS; cell++) {
+        s->cand[cell] = FULL;
+    }
+    for (int cell = 0; cell < CELLS; cell++) {
+        if (grid[cell] != 0 && !K(assign)(s, cell, (KMask) 1 << (grid[cell] - 1))) {
+            return false;
+        }
+    }
+    return K(propagate)(s);
+}
+
+/**
+ Starts a new search from the current, already propagated state, with no limit on the nodes
+ it may visit
+ @param s search state
+ */
+static void K(start)(K(Search) *s)
+{
+    s->depth = 0;
+    s->phase = PHASE_PICK;
+    s->budget = LONG_MAX;
+}
+
+/**
+ Searches onward for the next solution, branching on the most constrained cell and trying its
+ digits smallest first. After a solution is returned, calling this again backtracks from it and
+ continues the same search, so repeated calls enumerate every solution in order. The search
+ pauses when its node budget runs out, and calling this again picks up where it left off.
+ @param s search state, with a search started by K(start)
+ @return SEARCH_SOLUTION if the state now holds a solution, SEARCH_PAUSED if the budget ran
+ out first, or SEARCH_EXHAUSTED if there are no more solutions or the search was cancelled
+ */
+static SearchResult K(next)(K(Search) *s)
+{
+    while (true) {
+        if (s->phase == PHASE_DONE) {
+            return SEARCH_EXHAUSTED;
+        }
+        if (s->phase == PHASE_PICK) {
+            int cell = K(pickCell)(s);
+            if (cell < 0) {
+                s->phase = PHASE_RETRY;
+                return SEARCH_SOLUTION;
+            }
+            s->frameCell[s->depth] = cell;
+            s->frameMark[s->depth] = s->trailLen;
+            s->frameLeft[s->depth] = s->cand[cell];
+            s->depth++;
+            if (s->baseDepth + s->depth > s->stats->maxDepth) {
+                s->stats->maxDepth = s->baseDepth + s->depth;
+            }
+            s->phase = PHASE_FRESH;
+        }
+
+        //Move to the next branch, going back up once a cell has run out of digits
+        if (s->depth == 0 || (s->cancel && __atomic_load_n(s->cancel, __ATOMIC_RELAXED))) {
+            s->depth = 0;
+            s->phase = PHASE_DONE;
+            return SEARCH_EXHAUSTED;
+        }
+        if (s->budget == 0) {
+            return SEARCH_PAUSED;
+        }
+        //A fresh branch has no digit to take back yet
+        if (s->phase == PHASE_RETRY) {
+            s->stats->backtracks++;
+        }
+        s->phase = PHASE_RETRY;
+        int top = s->depth - 1;
+        K(undo)(s, s->frameMark[top]);
+        if (s->frameLeft[top] == 0) {
+            s->depth--;
+            continue;
+        }
+        KMask bit = K(lowest)(s->frameLeft[top]);
+        s->frameLeft[top] ^= bit;
+        s->stats->nodes++;
+        s->budget--;
+        if (K(assign)(s, s->frameCell[top], bit) && K(propagate)(s)) {
+            s->phase = PHASE_PICK;
+        }
+    }
+}
+
+/**
+ Searches from the current state for a solution
+ @param s search state, already propagated
+ @return true if a solution was found, false if there is none or the search was cancelled
+ */
+static bool K(search)(K(Search) *s)
+{
+    K(start)(s);
+    return K(next)(s) == SEARCH_SOLUTION;
+}
+
+/**
+ Loads a grid's givens into search state and starts a new search from them
+ @param s search state
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty
+ @return false if the givens lead to a contradiction, leaving nothing to search, true otherwise
+ */
+static bool K(begin)(K(Search) *s, int const *grid)
+{
+    bool consistent = K(load)(s, grid);
+    K(start)(s);
+    if (!consistent) {
+        s->phase = PHASE_DONE;
+    }
+    return consistent;
+}
+
+/**
+ Continues a search for at most a given number of nodes
+ @param s search state, with a search started by K(begin)
+ @param budget number of nodes to visit before pausing
+ @return SEARCH_SOLUTION, SEARCH_PAUSED or SEARCH_EXHAUSTED, as for K(next)
+ */
+static SearchResult K(step)(K(Search) *s, long budget)
+{
+    s->budget = budget;
+    return K(next)(s);
+}
+
+/**
+ Copies a solved state out to a grid
+ @param s search state with every cell solved
+ @param grid SIZE * SIZE cell values to fill in
+ */
+static void K(store)(K(Search) *s, int *grid)
+{
+    for (int cell = 0; cell < CELLS; cell++) {
+        grid[cell] = __builtin_ctzll(s->cand[cell]) + 1;
+    }
+}
+
+/**
+ Solves a grid of this kernel's dimension
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty, filled in with the
+ solution if one is found
+ @param stats counters to add this search's work to
+ @return true if solved, false otherwise
+ */
+static bool K(solvePropagate)(int *grid, SolveStats *stats)
+{
+    K(Search) *s = K(newSearch)(stats, NULL);
+    if (!s) {
+        return false;
+    }
+    bool solved = K(load)(s, grid) && K(search)(s);
+    if (solved) {
+        K(store)(s, grid);
+    }
+    free(s);
+    return solved;
+}
+
+/**
+ Counts the solutions of a grid of this kernel's dimension
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty
+ @param stats counters to add this search's work to
+ @param limit number of solutions to stop counting at
+ @return number of solutions, at most limit
+ */
+static long K(countSolutions)(int const *grid, SolveStats *stats, long limit)
+{
+    K(Search) *s = K(newSearch)(stats, NULL);
+    if (!s) {
+        return 0;
+    }
+    long count = 0;
+    if (K(load)(s, grid)) {
+        K(start)(s);
+        while (count < limit && K(next)(s) == SEARCH_SOLUTION) {
+            count++;
+        }
+    }
+    free(s);
+    return count;
+}
+
+/** Subtree of the search handed between threads, described by its candidates */
+typedef struct {
+    /** Number of branches taken from the root to reach this subtree */
+    int depth;
+
+    /** Candidates for every cell at the root of the subtree, after propagation */
+    KMask cand[CELLS];
+} K(Task);
+
+/** State shared by every thread of one parallel search */
+typedef struct {
+    /** One deque of tasks per worker */
+    Deque *deques;
+
+    /** Number of workers */
+    int workers;
+
+    /** Tasks at or above this depth are split into one task per branch instead of searched */
+    int splitDepth;
+
+    /** Number of tasks queued or being worked on, updated atomically */
+    int pending;
+
+    /** Set once enough solutions have been found, telling every worker to stop */
+    bool stop;
+
+    /** Number of solutions to stop at */
+    long limit;
+
+    /** Number of solutions found so far, updated atomically */
+    long solutions;
+
+    /** Grid to copy the first solution into, or NULL if only counting */
+    int *grid;
+
+    /** Work done by each worker */
+    SolveStats *stats;
+} K(Shared);
+
+/**
+ Makes a task holding a copy of the search's current candidates
+ @param s search state
+ @param depth depth of the task in the search tree
+ @return newly allocated task, or NULL if it couldn't be allocated
+ */
+static K(Task) *K(makeTask)(K(Search) *s, int depth)
+{
+    K(Task) *task = malloc(sizeof(K(Task)));
+    if (!task) {
+        return NULL;
+    }
+    task->depth = depth;
+    for (int cell = 0; cell < CELLS; cell++) {
+        task->cand[cell] = s->cand[cell];
+    }
+    return task;
+}
+
+/**
+ Resets the search state to the root of a task's subtree
+ @param s search state
+ @param task task to start from
+ */
+static void K(enterTask)(K(Search) *s, K(Task) const *task)
+{
+    for (int cell = 0; cell < CELLS; cell++) {
+        s->cand[cell] = task->cand[cell];
+    }
+    s->trailLen = 0;
+    s->queueLen = 0;
+    s->baseDepth = task->depth;
+}
+
+/**
+ Finds a task for a worker, first from its own deque and then by stealing from the others
+ @param shared shared search state
+ @param id index of the worker
+ @return a task, or NULL if none was available
+ */
+static K(Task) *K(nextTask)(K(Shared) *shared, int id)
+{
+    K(Task) *task = popBottom(&shared->deques[id]);
+    for (int i = 1; !task && i < shared->workers; i++) {
+        task = stealTop(&shared->deques[(id + i) % shared->workers]);
+    }
+    return task;
+}
+
+/**
+ Records a solution found by a worker. The first solution is copied out to the shared grid,
+ and reaching the limit tells every worker to stop.
+ @param shared shared search state
+ @param s solved search state
+ @return true if the search should go on, false if the limit has been reached
+ */
+static bool K(report)(K(Shared) *shared, K(Search) *s)
+{
+    long count = __atomic_add_fetch(&shared->solutions, 1, __ATOMIC_ACQ_REL);
+    if (count == 1 && shared->grid) {
+        K(store)(s, shared->grid);
+    }
+    if (count >= shared->limit) {
+        __atomic_store_n(&shared->stop, true, __ATOMIC_RELEASE);
+        return false;
+    }
+    return true;
+}
+
+/**
+ Searches the subtree below a worker's current state on the worker's own thread, reporting
+ every solution in it until the limit is reached
+ @param shared shared search state
+ @param s search state at the root of the subtree
+ */
+static void K(searchHere)(K(Shared) *shared, K(Search) *s)
+{
+    K(start)(s);
+    while (K(next)(s) == SEARCH_SOLUTION && K(report)(shared, s)) {
+    }
+}
+
+/**
+ Pool job for one parallel search worker. Shallow tasks are split into a task per branch,
+ pushed so that the smallest digit is popped next; deeper tasks are searched sequentially,
+ reporting every solution in them until the limit is reached.
+ @param context the shared search state
+ @param id index of the worker
+ */
+static void K(worker)(void *context, int id)
+{
+    K(Shared) *shared = context;
+    K(Search) *s = K(newSearch)(&shared->stats[id], &shared->stop);
+    if (!s) {
+        return;
+    }
+    while (!__atomic_load_n(&shared->stop, __ATOMIC_ACQUIRE)) {
+        K(Task) *task = K(nextTask)(shared, id);
+        if (!task) {
+            if (__atomic_load_n(&shared->pending, __ATOMIC_ACQUIRE) == 0) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        K(enterTask)(s, task);
+        int cell = K(pickCell)(s);
+        if (cell < 0) {
+            K(report)(shared, s);
+        }
+        else if (task->depth < shared->splitDepth) {
+            K(Task) *children[SIZE];
+            int count = 0;
+            for (KMask left = s->cand[cell]; left; left &= left - 1) {
+                K(enterTask)(s, task);
+                s->stats->nodes++;
+                if (K(assign)(s, cell, K(lowest)(left)) && K(propagate)(s)) {
+                    //A branch there's no memory to hand out is searched right away instead
+                    K(Task) *child = K(makeTask)(s, task->depth + 1);
+                    if (child) {
+                        children[count++] = child;
+                    }
+                    else {
+                        K(searchHere)(shared, s);
+                    }
+                }
+                else {
+                    s->stats->backtracks++;
+                }
+            }
+            if (task->depth + 1 > s->stats->maxDepth) {
+                s->stats->maxDepth = task->depth + 1;
+            }
+            __atomic_add_fetch(&shared->pending, count, __ATOMIC_ACQ_REL);
+            while (count > 0) {
+                K(Task) *child = children[--count];
+                if (!pushBottom(&shared->deques[id], child)) {
+                    K(enterTask)(s, child);
+                    K(searchHere)(shared, s);
+                    free(child);
+                    __atomic_sub_fetch(&shared->pending, 1, __ATOMIC_ACQ_REL);
+                }
+            }
+        }
+        else {
+            K(searchHere)(shared, s);
+        }
+        free(task);
+        __atomic_sub_fetch(&shared->pending, 1, __ATOMIC_ACQ_REL);
+    }
+    free(s);
+}
+
+/**
+ Searches a grid of this kernel's dimension on several threads. The top of the search tree is
+ split into tasks that workers share through work-stealing deques, and reaching the solution
+ limit stops every worker.
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty
+ @param solution grid to copy the first solution found into, or NULL if only counting
+ @param stats counters to add the work of every thread to
+ @param threads number of worker threads
+ @param limit number of solutions to stop at
+ @return number of solutions found, at most limit
+ */
+static long K(searchParallel)(int const *grid, int *solution, SolveStats *stats, int threads,
+                              long limit)
+{
+    K(Search) *s = K(newSearch)(stats, NULL);
+    if (!s) {
+        return 0;
+    }
+    if (!K(load)(s, grid)) {
+        free(s);
+        return 0;
+    }
+
+    Deque deques[threads];
+    SolveStats workerStats[threads];
+    K(Task) *root = K(makeTask)(s, 0);
+    bool ready = root != NULL;
+    for (int i = 0; i < threads; i++) {
+        ready = initDeque(&deques[i]) && ready;
+        workerStats[i] = (SolveStats) { 0 };
+    }
+    if (!ready) {
+        //Without memory for tasks, search on this thread alone
+        long count = 0;
+        K(start)(s);
+        while (count < limit && K(next)(s) == SEARCH_SOLUTION) {
+            if (count++ == 0 && solution) {
+                K(store)(s, solution);
+            }
+        }
+        for (int i = 0; i < threads; i++) {
+            freeDeque(&deques[i]);
+        }
+        free(root);
+        free(s);
+        return count;
+    }
+    //Split a few levels deeper than it takes to give every thread a task of its own
+    int splitDepth = 4;
+    for (int t = 1; t < threads; t *= 2) {
+        splitDepth++;
+    }
+    K(Shared) shared = { deques, threads, splitDepth, 1, false, limit, 0, solution, workerStats };
+    //An empty deque always has room, so the root task can't fail to go in
+    pushBottom(&deques[0], root);
+    free(s);
+
+    runPool(threads, threads, K(worker), &shared);
+
+    for (int i = 0; i < threads; i++) {
+        for (K(Task) *task; (task = popBottom(&deques[i])); ) {
+            free(task);
+        }
+        freeDeque(&deques[i]);
+        addStats(stats, &workerStats[i]);
+    }
+    return shared.solutions < limit ? shared.solutions : limit;
+}
+
+/**
+ Solves a grid of this kernel's dimension on several threads, stopping at the first solution
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty, filled in with the
+ solution if one is found
+ @param stats counters to add the work of every thread to
+ @param threads number of worker threads
+ @return true if solved, false otherwise
+ */
+static bool K(solveParallel)(int *grid, SolveStats *stats, int threads)
+{
+    return K(searchParallel)(grid, grid, stats, threads, 1) == 1;
+}
+
+/**
+ Counts the solutions of a grid of this kernel's dimension on several threads
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty
+ @param stats counters to add the work of every thread to
+ @param threads number of worker threads
+ @param limit number of solutions to stop counting at
+ @return number of solutions, at most limit
+ */
+static long K(countParallel)(int const *grid, SolveStats *stats, int threads, long limit)
+{
+    return K(searchParallel)(grid, NULL, stats, threads, limit);
+}
+
+#undef KERNEL_PASTE
+#undef KERNEL_PASTE2
+#undef K
+#undef N
+#undef SIZE
+#undef CELLS
+#undef UNIT_KINDS
+#undef KMask
+#undef FULL
+#undef KERNEL_N
+#undef KERNEL_MASK
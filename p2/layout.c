@@ -0,0 +1,99 @@
+/**
+ @file layout.c
+ @author Matthew Kierski (mdkiersk)
+ Builds the layout of every supported grid size once, the first time any of them is needed.
+ Each layout's tables are kept in static storage sized for the largest grid, so building them
+ can't run out of memory.
+ */
+
+#include "layout.h"
+#include "solve.h"
+#include <pthread.h>
+#include <stdint.h>
+
+/** Number of cells in the largest grid */
+#define MAX_CELLS (MAX_SUBGRID * MAX_SUBGRID * MAX_SUBGRID * MAX_SUBGRID)
+
+/** Layout of each size, indexed by subgrid dimension */
+static Layout layouts[MAX_SUBGRID + 1];
+
+/** Tables of the layout of one size, only partly used for sizes below the largest */
+typedef struct {
+    /** Cells of every unit; first so they stay aligned for 16-bit access */
+    uint16_t units[UNIT_KINDS * MAX_CELLS];
+
+    /** Row of each cell */
+    uint8_t row[MAX_CELLS];
+
+    /** Column of each cell */
+    uint8_t col[MAX_CELLS];
+
+    /** Subgrid of each cell */
+    uint8_t box[MAX_CELLS];
+} Tables;
+
+/** Tables of each size, indexed by subgrid dimension */
+static Tables tables[MAX_SUBGRID + 1];
+
+/** Makes sure the layouts are built exactly once */
+static pthread_once_t built = PTHREAD_ONCE_INIT;
+
+/**
+ Builds the layout of one size
+ @param layout layout to fill in
+ @param n dimension of subgrids
+ */
+static void buildLayout(Layout *layout, int n)
+{
+    int size = n * n;
+    int cells = size * size;
+    uint16_t *units = tables[n].units;
+    uint8_t *row = tables[n].row;
+    uint8_t *col = tables[n].col;
+    uint8_t *box = tables[n].box;
+    for (int cell = 0; cell < cells; cell++) {
+        int r = cell / size;
+        int c = cell % size;
+        row[cell] = r;
+        col[cell] = c;
+        box[cell] = (r / n) * n + c / n;
+        units[r * size + c] = cell;
+        units[(size + c) * size + r] = cell;
+        units[(2 * size + box[cell]) * size + (r % n) * n + c % n] = cell;
+    }
+    *layout = (Layout) { n, size, cells, row, col, box, units };
+}
+
+/**
+ Builds the layouts of every supported size
+ */
+static void buildLayouts(void)
+{
+    for (int n = MIN_SUBGRID; n <= MAX_SUBGRID; n++) {
+        buildLayout(&layouts[n], n);
+    }
+}
+
+extern Layout const *layoutFor(int n)
+{
+    pthread_once(&built, buildLayouts);
+    return &layouts[n];
+}
+
+extern void packGrid(int size, int grid[size][size], uint8_t *cells)
+{
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            cells[r * size + c] = grid[r][c];
+        }
+    }
+}
+
+extern void unpackGrid(int size, uint8_t const *cells, int grid[size][size])
+{
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            grid[r][c] = cells[r * size + c];
+        }
+    }
+}
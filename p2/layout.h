@@ -0,0 +1,67 @@
+/**
+ @file layout.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the layout component, which describes the shape of a grid of each supported size:
+ the row, column and subgrid of every cell and the cells of every row, column and subgrid. The
+ tables are built once per size and shared, so hot loops look indices up instead of dividing.
+ It also packs grids into one byte per cell, which keeps a 16x16 grid in four cache lines.
+ */
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <stdint.h>
+
+/** Number of kinds of unit: rows, columns and subgrids */
+#define UNIT_KINDS 3
+
+/** Shape of a grid of one size */
+typedef struct {
+    /** Dimension of subgrids */
+    int n;
+
+    /** Dimension of entire grid */
+    int size;
+
+    /** Number of cells in the grid */
+    int cells;
+
+    /** Row of each cell, in row-major order */
+    uint8_t const *row;
+
+    /** Column of each cell */
+    uint8_t const *col;
+
+    /** Subgrid of each cell, numbered in row-major order */
+    uint8_t const *box;
+
+    /** Cells of each of the UNIT_KINDS * size units (rows, then columns, then subgrids), size
+     cells per unit */
+    uint16_t const *units;
+} Layout;
+
+/**
+ Gives the layout for a subgrid dimension, building the layouts of every size the first time
+ it is called. Safe to call from any thread.
+ @param n dimension of subgrids, from MIN_SUBGRID to MAX_SUBGRID
+ @return layout shared by every caller
+ */
+Layout const *layoutFor(int n);
+
+/**
+ Packs a grid into one byte per cell
+ @param size dimension of entire grid
+ @param grid 2D array to pack; every value must be from 0 to size
+ @param cells filled in with size * size values in row-major order
+ */
+void packGrid(int size, int grid[size][size], uint8_t *cells);
+
+/**
+ Unpacks a grid packed with packGrid
+ @param size dimension of entire grid
+ @param cells size * size values in row-major order
+ @param grid 2D array filled in with the values
+ */
+void unpackGrid(int size, uint8_t const *cells, int grid[size][size]);
+
+#endif
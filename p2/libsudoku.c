@@ -0,0 +1,114 @@
+/**
+ @file libsudoku.c
+ @author Matthew Kierski (mdkiersk)
+ Wraps a reusable propagate search in a context object. The search state is allocated once,
+ sized for the context's grid, and every later call works inside it.
+ */
+
+#include "libsudoku.h"
+#include "propagate.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+
+/** Solver state for puzzles of one size */
+struct SudokuContext {
+    /** Dimension of subgrids */
+    int n;
+
+    /** Dimension of entire grid */
+    int size;
+
+    /** Search state for grids of this size, from newPropagateSearch */
+    void *search;
+
+    /** State of the loaded puzzle */
+    SudokuStatus status;
+
+    /** Work done on the loaded puzzle so far */
+    SolveStats stats;
+};
+
+extern SudokuContext *sudokuCreate(int size)
+{
+    int n = 0;
+    for (int k = MIN_SUBGRID; k <= MAX_SUBGRID; k++) {
+        if (k * k == size) {
+            n = k;
+        }
+    }
+    if (n == 0) {
+        return NULL;
+    }
+    SudokuContext *ctx = malloc(sizeof(SudokuContext));
+    if (!ctx) {
+        return NULL;
+    }
+    ctx->n = n;
+    ctx->size = size;
+    ctx->status = SUDOKU_BAD_INPUT;
+    ctx->stats = (SolveStats) { 0 };
+    ctx->search = newPropagateSearch(n, &ctx->stats);
+    if (!ctx->search) {
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+extern void sudokuDestroy(SudokuContext *ctx)
+{
+    if (ctx) {
+        free(ctx->search);
+        free(ctx);
+    }
+}
+
+extern SudokuStatus sudokuLoad(SudokuContext *ctx, int const *grid)
+{
+    ctx->stats = (SolveStats) { 0 };
+    for (int i = 0; i < ctx->size * ctx->size; i++) {
+        if (grid[i] < 0 || grid[i] > ctx->size) {
+            return ctx->status = SUDOKU_BAD_INPUT;
+        }
+    }
+    bool consistent = beginPropagateSearch(ctx->n, ctx->search, grid);
+    return ctx->status = consistent ? SUDOKU_RUNNING : SUDOKU_UNSOLVABLE;
+}
+
+extern SudokuStatus sudokuStep(SudokuContext *ctx, long budget)
+{
+    if (ctx->status == SUDOKU_BAD_INPUT || ctx->status == SUDOKU_UNSOLVABLE) {
+        return ctx->status;
+    }
+    switch (stepPropagateSearch(ctx->n, ctx->search, budget > 0 ? budget : LONG_MAX)) {
+    case SEARCH_SOLUTION:
+        return ctx->status = SUDOKU_SOLVED;
+    case SEARCH_PAUSED:
+        return ctx->status = SUDOKU_RUNNING;
+    default:
+        return ctx->status = SUDOKU_UNSOLVABLE;
+    }
+}
+
+extern SudokuStatus sudokuSolve(SudokuContext *ctx, int *grid)
+{
+    if (sudokuLoad(ctx, grid) == SUDOKU_RUNNING && sudokuStep(ctx, 0) == SUDOKU_SOLVED) {
+        sudokuSolution(ctx, grid);
+    }
+    return ctx->status;
+}
+
+extern bool sudokuSolution(SudokuContext *ctx, int *grid)
+{
+    if (ctx->status != SUDOKU_SOLVED) {
+        return false;
+    }
+    storePropagateSearch(ctx->n, ctx->search, grid);
+    return true;
+}
+
+extern SolveStats const *sudokuStats(SudokuContext const *ctx)
+{
+    return &ctx->stats;
+}
@@ -0,0 +1,92 @@
+/**
+ @file libsudoku.h
+ @author Matthew Kierski (mdkiersk)
+ Public interface of libsudoku, the propagate solver packaged for use from other programs.
+ All state lives in a context that the caller creates once and reuses for any number of
+ puzzles of one size. Loading, solving and stepping never allocate memory, and separate
+ contexts may be used on separate threads at the same time. Long searches can be time-sliced
+ by stepping them with a node budget.
+ */
+
+#ifndef LIBSUDOKU_H
+#define LIBSUDOKU_H
+
+#include "solve.h"
+#include <stdbool.h>
+
+/** Solver state for puzzles of one size, created with sudokuCreate */
+typedef struct SudokuContext SudokuContext;
+
+/** State of the puzzle loaded into a context */
+typedef enum {
+    /** The search has found a solution, which sudokuSolution copies out */
+    SUDOKU_SOLVED,
+
+    /** The search has more work to do; step it again to carry on */
+    SUDOKU_RUNNING,
+
+    /** The puzzle has no solution, or no more solutions than the ones already found */
+    SUDOKU_UNSOLVABLE,
+
+    /** The puzzle has values out of range, or no puzzle has been loaded */
+    SUDOKU_BAD_INPUT
+} SudokuStatus;
+
+/**
+ Creates a solver context for puzzles of one size. This is the only call that allocates.
+ @param size dimension of entire grid: 4, 9, 16, 25, 36 or 49
+ @return new context, or NULL if the size is unsupported or memory ran out
+ */
+SudokuContext *sudokuCreate(int size);
+
+/**
+ Frees a context and everything it holds
+ @param ctx context to free, or NULL
+ */
+void sudokuDestroy(SudokuContext *ctx);
+
+/**
+ Loads a puzzle into a context, replacing any puzzle it held, and resets its counters
+ @param ctx context to load into
+ @param grid size * size cell values in row-major order, 0 for empty
+ @return SUDOKU_RUNNING if the puzzle is ready to search, SUDOKU_UNSOLVABLE if its givens
+ already conflict, or SUDOKU_BAD_INPUT if a value is out of range
+ */
+SudokuStatus sudokuLoad(SudokuContext *ctx, int const *grid);
+
+/**
+ Searches the loaded puzzle for at most a given number of nodes, returning as soon as a
+ solution is found or the budget runs out. Stepping again after SUDOKU_SOLVED looks for
+ another solution, so stepping until SUDOKU_UNSOLVABLE enumerates every solution.
+ @param ctx context holding the puzzle
+ @param budget most nodes (tentative digits) to try, or 0 for no limit
+ @return SUDOKU_SOLVED, SUDOKU_RUNNING, SUDOKU_UNSOLVABLE, or SUDOKU_BAD_INPUT if no
+ puzzle is loaded
+ */
+SudokuStatus sudokuStep(SudokuContext *ctx, long budget);
+
+/**
+ Solves a puzzle in one call, loading it and stepping without a budget
+ @param ctx context to solve with
+ @param grid size * size cell values in row-major order, 0 for empty, filled in with the
+ solution if one is found
+ @return SUDOKU_SOLVED, SUDOKU_UNSOLVABLE or SUDOKU_BAD_INPUT
+ */
+SudokuStatus sudokuSolve(SudokuContext *ctx, int *grid);
+
+/**
+ Copies out the solution found by the last step
+ @param ctx context holding the puzzle
+ @param grid size * size cell values to fill in, in row-major order
+ @return true if the context holds a solution, false otherwise
+ */
+bool sudokuSolution(SudokuContext *ctx, int *grid);
+
+/**
+ Gives the counters for the work done on the loaded puzzle so far. Time is not measured.
+ @param ctx context holding the puzzle
+ @return the context's counters, valid until it is destroyed
+ */
+SolveStats const *sudokuStats(SudokuContext const *ctx);
+
+#endif
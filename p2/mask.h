@@ -0,0 +1,77 @@
+/**
+ @file mask.h
+ @author Matthew Kierski (mdkiersk)
+ Digit masks shared by the solving and validating components. A mask holds a set of digits,
+ where bit d - 1 is set when digit d is in the set.
+ */
+
+#ifndef MASK_H
+#define MASK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Set of digits, one bit per digit, wide enough for the largest supported grid */
+typedef uint64_t Mask;
+
+/**
+ Converts a digit into its bit in a digit mask
+ @param digit digit in the range 1 to size
+ @return mask with only that digit's bit set
+ */
+static inline Mask digitBit(int digit)
+{
+    return (Mask) 1 << (digit - 1);
+}
+
+/**
+ Converts a mask with exactly one bit set back into its digit
+ @param bit mask with one bit set
+ @return digit represented by the bit
+ */
+static inline int bitDigit(Mask bit)
+{
+    return __builtin_ctzll(bit) + 1;
+}
+
+/**
+ Returns the mask containing every digit from 1 to size
+ @param size dimension of entire grid
+ @return mask with the low size bits set
+ */
+static inline Mask fullMask(int size)
+{
+    return ((Mask) 1 << size) - 1;
+}
+
+/**
+ Returns the smallest digit in a mask, as a mask
+ @param mask nonempty set of digits
+ @return mask holding only the smallest digit
+ */
+static inline Mask lowestBit(Mask mask)
+{
+    return mask & -mask;
+}
+
+/**
+ Counts the digits in a mask
+ @param mask set of digits
+ @return number of digits in the set
+ */
+static inline int countDigits(Mask mask)
+{
+    return __builtin_popcountll(mask);
+}
+
+/**
+ Checks whether a mask holds exactly one digit
+ @param mask set of digits
+ @return true if the mask has a single bit set
+ */
+static inline bool singleDigit(Mask mask)
+{
+    return mask != 0 && (mask & (mask - 1)) == 0;
+}
+
+#endif
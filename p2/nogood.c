@@ -0,0 +1,138 @@
+/**
+ @file nogood.c
+ @author Matthew Kierski (mdkiersk)
+ Keeps nogoods in a table of two-entry slots indexed by the low bits of their hash. A lookup
+ compares the whole 64-bit hash and the depth, so a false match needs two different states to
+ collide in every bit. When both entries of a slot are taken, the table's replacement policy
+ picks which nogood to keep.
+ */
+
+#include "nogood.h"
+#include "layout.h"
+#include "util.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Number of entries in each slot */
+#define WAYS 2
+
+/** Seed for the Zobrist keys; any value works, but a fixed one keeps runs repeatable */
+#define ZOBRIST_SEED 0x5EED5EED5EED5EEDULL
+
+/** A state known to have no solution */
+typedef struct {
+    /** Hash of the state */
+    uint64_t hash;
+
+    /** Depth of the state plus one, or 0 if the entry is empty */
+    int depth;
+} Entry;
+
+/** Table of subproblems known to have no solution */
+struct NogoodTable {
+    /** Which entry to give up when a slot is full */
+    Replacement replace;
+
+    /** Mask selecting a slot from a hash; the number of slots is a power of two */
+    uint64_t slotMask;
+
+    /** WAYS entries for each slot */
+    Entry *entries;
+
+    /** Key of each digit in each cell, at cell * (size + 1) + digit */
+    uint64_t *keys;
+};
+
+extern NogoodTable *newNogoodTable(int n, NogoodOptions const *options)
+{
+    int size = n * n;
+    long slots = 1;
+    while (slots * 2 * WAYS * (long) sizeof(Entry) <= options->bytes) {
+        slots *= 2;
+    }
+    if (slots * WAYS * (long) sizeof(Entry) > options->bytes) {
+        return NULL;
+    }
+    NogoodTable *table = malloc(sizeof(NogoodTable));
+    if (!table) {
+        return NULL;
+    }
+    table->replace = options->replace;
+    table->slotMask = slots - 1;
+    table->entries = calloc(slots * WAYS, sizeof(Entry));
+    table->keys = malloc(sizeof(uint64_t) * size * size * (size + 1));
+    uint64_t *unitKeys = malloc(sizeof(uint64_t) * UNIT_KINDS * size * (size + 1));
+    if (!table->entries || !table->keys || !unitKeys) {
+        free(unitKeys);
+        freeNogoodTable(table);
+        return NULL;
+    }
+    uint64_t state = ZOBRIST_SEED;
+    for (int i = 0; i < UNIT_KINDS * size * (size + 1); i++) {
+        unitKeys[i] = nextRandom(&state);
+    }
+    //Combine each cell's three unit keys ahead of time, so the search needs a single load
+    Layout const *layout = layoutFor(n);
+    for (int cell = 0; cell < size * size; cell++) {
+        int units[UNIT_KINDS] = { layout->row[cell], size + layout->col[cell],
+                                  2 * size + layout->box[cell] };
+        for (int digit = 0; digit <= size; digit++) {
+            uint64_t key = 0;
+            for (int k = 0; k < UNIT_KINDS; k++) {
+                key ^= unitKeys[units[k] * (size + 1) + digit];
+            }
+            table->keys[cell * (size + 1) + digit] = key;
+        }
+    }
+    free(unitKeys);
+    return table;
+}
+
+extern void freeNogoodTable(NogoodTable *table)
+{
+    if (table) {
+        free(table->entries);
+        free(table->keys);
+        free(table);
+    }
+}
+
+extern uint64_t const *nogoodKeys(NogoodTable const *table)
+{
+    return table->keys;
+}
+
+extern bool findNogood(NogoodTable const *table, uint64_t hash, int depth)
+{
+    Entry const *slot = &table->entries[(hash & table->slotMask) * WAYS];
+    for (int way = 0; way < WAYS; way++) {
+        if (slot[way].hash == hash && slot[way].depth == depth + 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+extern void addNogood(NogoodTable *table, uint64_t hash, int depth)
+{
+    Entry *slot = &table->entries[(hash & table->slotMask) * WAYS];
+    Entry entry = { hash, depth + 1 };
+    if (table->replace == REPLACE_RECENT) {
+        //Newest first, so the older entry is the one pushed out
+        slot[1] = slot[0];
+        slot[0] = entry;
+        return;
+    }
+    //A shallower nogood rules out a bigger subtree, so it is worth more than a deeper one
+    Entry *victim = slot[1].depth > slot[0].depth ? &slot[1] : &slot[0];
+    if (slot[0].depth == 0) {
+        victim = &slot[0];
+    }
+    else if (slot[1].depth == 0) {
+        victim = &slot[1];
+    }
+    if (victim->depth == 0 || entry.depth <= victim->depth) {
+        *victim = entry;
+    }
+}
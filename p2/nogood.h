@@ -0,0 +1,62 @@
+/**
+ @file nogood.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the nogood component, a fixed-size transposition table of subproblems a search has
+ proven to have no solution. States are identified by Zobrist hashes that are updated
+ incrementally as digits are placed and removed.
+ */
+
+#ifndef NOGOOD_H
+#define NOGOOD_H
+
+#include "solve.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Table of subproblems known to have no solution */
+typedef struct NogoodTable NogoodTable;
+
+/**
+ Creates an empty table for grids of one size
+ @param n dimension of subgrids
+ @param options memory to use and replacement policy
+ @return new table, or NULL if the memory allowed is too small for a single slot or memory
+ ran out
+ */
+NogoodTable *newNogoodTable(int n, NogoodOptions const *options);
+
+/**
+ Frees a table
+ @param table table to free, or NULL
+ */
+void freeNogoodTable(NogoodTable *table);
+
+/**
+ Gives the Zobrist keys to XOR into a state's hash when a digit is placed in, or removed from,
+ a cell. A key is the combination of random keys for the digit in each of the cell's row,
+ column and subgrid, so two states hash alike whenever their units hold the same digits.
+ @param table table whose keys to use
+ @return size * size * (size + 1) keys, the key of a digit in a cell being at
+ cell * (size + 1) + digit
+ */
+uint64_t const *nogoodKeys(NogoodTable const *table);
+
+/**
+ Checks whether a state is known to have no solution
+ @param table table to look in
+ @param hash hash of the state
+ @param depth number of cells the search had filled on reaching the state
+ @return true if the state is in the table, false otherwise
+ */
+bool findNogood(NogoodTable const *table, uint64_t hash, int depth);
+
+/**
+ Records that a state has no solution, replacing an entry in its slot according to the
+ table's policy if the slot is full
+ @param table table to add to
+ @param hash hash of the state
+ @param depth number of cells the search had filled on reaching the state
+ */
+void addNogood(NogoodTable *table, uint64_t hash, int depth);
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ @file propagate.c
+ @author Matthew Kierski (mdkiersk)
+ Solves grids by constraint propagation with minimum-remaining-values branching. The search
+ itself lives in kernel.h, which is compiled here once for every supported subgrid dimension,
+ and the functions below pick the kernel matching the grid.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "propagate.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define KERNEL_N 2
+#define KERNEL_MASK uint32_t
+#include "kernel.h"
+
+#define KERNEL_N 3
+#define KERNEL_MASK uint32_t
+#include "kernel.h"
+
+#define KERNEL_N 4
+#define KERNEL_MASK uint32_t
+#include "kernel.h"
+
+#define KERNEL_N 5
+#define KERNEL_MASK uint32_t
+#include "kernel.h"
+
+#define KERNEL_N 6
+#define KERNEL_MASK uint64_t
+#include "kernel.h"
+
+#define KERNEL_N 7
+#define KERNEL_MASK uint64_t
+#include "kernel.h"
+
+extern bool solvePropagate(int n, int size, int grid[size][size], SolveStats *stats)
+{
+    switch (n) {
+    case 2:
+        return solvePropagate2(&grid[0][0], stats);
+    case 3:
+        return solvePropagate3(&grid[0][0], stats);
+    case 4:
+        return solvePropagate4(&grid[0][0], stats);
+    case 5:
+        return solvePropagate5(&grid[0][0], stats);
+    case 6:
+        return solvePropagate6(&grid[0][0], stats);
+    case 7:
+        return solvePropagate7(&grid[0][0], stats);
+    default:
+        return false;
+    }
+}
+
+extern bool solvePropagateParallel(int n, int size, int grid[size][size], SolveStats *stats,
+                                   int threads)
+{
+    switch (n) {
+    case 2:
+        return solveParallel2(&grid[0][0], stats, threads);
+    case 3:
+        return solveParallel3(&grid[0][0], stats, threads);
+    case 4:
+        return solveParallel4(&grid[0][0], stats, threads);
+    case 5:
+        return solveParallel5(&grid[0][0], stats, threads);
+    case 6:
+        return solveParallel6(&grid[0][0], stats, threads);
+    case 7:
+        return solveParallel7(&grid[0][0], stats, threads);
+    default:
+        return false;
+    }
+}
+
+extern long countPropagate(int n, int size, int grid[size][size], SolveStats *stats, int threads,
+                           long limit)
+{
+    int *cells = &grid[0][0];
+    switch (n) {
+    case 2:
+        return threads > 1 ? countParallel2(cells, stats, threads, limit)
+                           : countSolutions2(cells, stats, limit);
+    case 3:
+        return threads > 1 ? countParallel3(cells, stats, threads, limit)
+                           : countSolutions3(cells, stats, limit);
+    case 4:
+        return threads > 1 ? countParallel4(cells, stats, threads, limit)
+                           : countSolutions4(cells, stats, limit);
+    case 5:
+        return threads > 1 ? countParallel5(cells, stats, threads, limit)
+                           : countSolutions5(cells, stats, limit);
+    case 6:
+        return threads > 1 ? countParallel6(cells, stats, threads, limit)
+                           : countSolutions6(cells, stats, limit);
+    case 7:
+        return threads > 1 ? countParallel7(cells, stats, threads, limit)
+                           : countSolutions7(cells, stats, limit);
+    default:
+        return 0;
+    }
+}
+
+extern void *newPropagateSearch(int n, SolveStats *stats)
+{
+    switch (n) {
+    case 2:
+        return newSearch2(stats, NULL);
+    case 3:
+        return newSearch3(stats, NULL);
+    case 4:
+        return newSearch4(stats, NULL);
+    case 5:
+        return newSearch5(stats, NULL);
+    case 6:
+        return newSearch6(stats, NULL);
+    case 7:
+        return newSearch7(stats, NULL);
+    default:
+        return NULL;
+    }
+}
+
+extern bool beginPropagateSearch(int n, void *search, int const *grid)
+{
+    switch (n) {
+    case 2:
+        return begin2(search, grid);
+    case 3:
+        return begin3(search, grid);
+    case 4:
+        return begin4(search, grid);
+    case 5:
+        return begin5(search, grid);
+    case 6:
+        return begin6(search, grid);
+    case 7:
+        return begin7(search, grid);
+    default:
+        return false;
+    }
+}
+
+extern SearchResult stepPropagateSearch(int n, void *search, long budget)
+{
+    switch (n) {
+    case 2:
+        return step2(search, budget);
+    case 3:
+        return step3(search, budget);
+    case 4:
+        return step4(search, budget);
+    case 5:
+        return step5(search, budget);
+    case 6:
+        return step6(search, budget);
+    case 7:
+        return step7(search, budget);
+    default:
+        return SEARCH_EXHAUSTED;
+    }
+}
+
+extern void storePropagateSearch(int n, void *search, int *grid)
+{
+    switch (n) {
+    case 2:
+        store2(search, grid);
+        break;
+    case 3:
+        store3(search, grid);
+        break;
+    case 4:
+        store4(search, grid);
+        break;
+    case 5:
+        store5(search, grid);
+        break;
+    case 6:
+        store6(search, grid);
+        break;
+    case 7:
+        store7(search, grid);
+        break;
+    }
+}
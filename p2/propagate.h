@@ -0,0 +1,103 @@
+/**
+ @file propagate.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the propagate component, which solves grids by logical deduction (naked singles,
+ hidden singles and box/line reduction) and branches on the most constrained cell only when
+ deduction gets stuck.
+ */
+
+#ifndef PROPAGATE_H
+#define PROPAGATE_H
+
+#include "solve.h"
+#include <stdbool.h>
+
+/** Outcome of running a search until it stops */
+typedef enum {
+    /** The search reached a solution; resuming it looks for another */
+    SEARCH_SOLUTION,
+
+    /** The search used up its node budget; resuming it carries on */
+    SEARCH_PAUSED,
+
+    /** The search has no more solutions to find */
+    SEARCH_EXHAUSTED
+} SearchResult;
+
+/**
+ Attempts to solve a grid using constraint propagation and minimum-remaining-values branching
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, filled in with the solution if one is found
+ @param stats counters to add this search's work to
+ @return true if solved, false otherwise
+ */
+bool solvePropagate(int n, int size, int grid[size][size], SolveStats *stats);
+
+/**
+ Attempts to solve a grid with the same search as solvePropagate, spread over several threads.
+ The top of the search tree is split into tasks that workers take from each other's
+ work-stealing deques, and the first solution found cancels the rest of the search. When the
+ puzzle has a unique solution, the result is the same as solvePropagate's.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, filled in with the solution if one is found
+ @param stats counters to add the work of every thread to
+ @param threads number of worker threads
+ @return true if solved, false otherwise
+ */
+bool solvePropagateParallel(int n, int size, int grid[size][size], SolveStats *stats,
+                            int threads);
+
+/**
+ Counts the solutions of a grid with the same search as solvePropagate, stopping as soon as
+ the limit is reached. With more than one thread, the search tree is shared out the same way
+ as solvePropagateParallel's.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, left unchanged
+ @param stats counters to add the work of every thread to
+ @param threads number of worker threads
+ @param limit number of solutions to stop counting at
+ @return number of solutions, at most limit
+ */
+long countPropagate(int n, int size, int grid[size][size], SolveStats *stats, int threads,
+                    long limit);
+
+/**
+ Allocates the state for a propagate search that can be run a step at a time and reused for
+ any number of grids. Nothing else is allocated while it runs.
+ @param n dimension of subgrids
+ @param stats counters the search adds its work to
+ @return search state, to be released with free, or NULL if n is unsupported or memory ran out
+ */
+void *newPropagateSearch(int n, SolveStats *stats);
+
+/**
+ Loads a grid's givens into a search and starts searching them
+ @param n dimension of subgrids the search was allocated for
+ @param search search state
+ @param grid n^4 cell values in row-major order, 0 for empty
+ @return false if the givens lead to a contradiction, true otherwise
+ */
+bool beginPropagateSearch(int n, void *search, int const *grid);
+
+/**
+ Runs a search until it finds a solution, runs out of grid to search or has visited a given
+ number of nodes. After a solution, stepping again looks for the next one.
+ @param n dimension of subgrids the search was allocated for
+ @param search search state, started with beginPropagateSearch
+ @param budget most nodes to visit before pausing
+ @return SEARCH_SOLUTION, SEARCH_PAUSED or SEARCH_EXHAUSTED
+ */
+SearchResult stepPropagateSearch(int n, void *search, long budget);
+
+/**
+ Copies the solution a search has just found
+ @param n dimension of subgrids the search was allocated for
+ @param search search state, whose last step returned SEARCH_SOLUTION
+ @param grid n^4 cell values to fill in, in row-major order
+ */
+void storePropagateSearch(int n, void *search, int *grid);
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ @file puzzle.c
+ @author Matthew Kierski (mdkiersk)
+ Reads puzzles in either the size-and-grid format or the one-line 9x9 format, checks them
+ with the validate and solve components, and prints the results.
+ */
+
+#include "puzzle.h"
+#include "solve.h"
+#include "canon.h"
+#include "cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+//Proper size for 9x9 grid
+#define NINEXNINE 9
+//Proper dimension of 9x9 subgrid
+#define NINE_SUBGRID 3
+//Length of a puzzle written on one line
+#define ONE_LINE_LEN (NINEXNINE * NINEXNINE)
+//Milliseconds in a second
+#define MILLIS 1000.0
+
+/**
+ Determines whether a token is a whole puzzle written on one line
+ @param token whitespace-delimited token from the input
+ @return true if the token is 81 digits or dots, false otherwise
+ */
+static bool isOneLine(char const *token)
+{
+    if (strlen(token) != ONE_LINE_LEN) {
+        return false;
+    }
+    for (int i = 0; i < ONE_LINE_LEN; i++) {
+        if ((token[i] < '0' || token[i] > '9') && token[i] != '.') {
+            return false;
+        }
+    }
+    return true;
+}
+
+extern int subgridFor(long size)
+{
+    for (int n = MIN_SUBGRID; n <= MAX_SUBGRID; n++) {
+        if (n * n == size) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+extern bool readPuzzle(FILE *fp, Puzzle *puzzle)
+{
+    puzzle->n = 0;
+    puzzle->size = 0;
+    puzzle->grid = NULL;
+    puzzle->outcome = PUZZLE_UNCHECKED;
+    puzzle->stats = (SolveStats) { 0 };
+    puzzle->solutions = 0;
+    puzzle->countCapped = false;
+
+    char token[ONE_LINE_LEN + 2];
+    if (fscanf(fp, "%82s", token) != 1) {
+        return false;
+    }
+
+    //One-line puzzles are always 9x9
+    if (isOneLine(token)) {
+        puzzle->n = NINE_SUBGRID;
+        puzzle->size = NINEXNINE;
+        puzzle->grid = malloc(sizeof(int) * ONE_LINE_LEN);
+        if (!puzzle->grid) {
+            puzzle->outcome = PUZZLE_NO_MEMORY;
+            return true;
+        }
+        for (int i = 0; i < ONE_LINE_LEN; i++) {
+            puzzle->grid[i] = token[i] == '.' ? 0 : token[i] - '0';
+        }
+        return true;
+    }
+
+    //Otherwise the token is the size, followed by the grid values
+    char *end;
+    long size = strtol(token, &end, 10);
+    int n = end == token ? 0 : subgridFor(size);
+    if (n == 0) {
+        puzzle->outcome = PUZZLE_BAD_SIZE;
+        return true;
+    }
+    puzzle->n = n;
+    puzzle->size = size;
+    puzzle->grid = malloc(sizeof(int) * size * size);
+    if (!puzzle->grid) {
+        puzzle->outcome = PUZZLE_NO_MEMORY;
+        return true;
+    }
+    if (*end != '\0') {
+        puzzle->outcome = PUZZLE_BAD_INPUT;
+        return true;
+    }
+    for (int i = 0; i < size * size; i++) {
+        int *cell = &puzzle->grid[i];
+        if (fscanf(fp, "%d", cell) != 1 || *cell < 0 || *cell > size) {
+            puzzle->outcome = PUZZLE_BAD_INPUT;
+            return true;
+        }
+    }
+    return true;
+}
+
+/**
+ Solves an incomplete puzzle, looking it up in the cache first if there is one. A puzzle found
+ in the cache has its canonical solution mapped back through its transform without searching,
+ and a puzzle that isn't found is added along with the result of solving it.
+ @param puzzle puzzle to solve; its grid is filled in with the solution
+ @param options how to solve the puzzle
+ @return true if solved, false if the puzzle has no solution
+ */
+static bool solvePuzzle(Puzzle *puzzle, CheckOptions const *options)
+{
+    int n = puzzle->n;
+    int size = puzzle->size;
+    int (*grid)[size] = (int (*)[size]) puzzle->grid;
+    int threads = options->threads;
+    Transform transform;
+    int canon[size][size];
+    bool cached = options->cache && canonicalForm(n, size, grid, canon, &transform);
+    if (cached) {
+        int solution[size][size];
+        switch (lookupCache(options->cache, size, &canon[0][0], &solution[0][0])) {
+        case CACHE_SOLVED:
+            undoTransform(size, &transform, solution, grid);
+            return true;
+        case CACHE_NO_SOLUTION:
+            return false;
+        default:
+            break;
+        }
+    }
+    bool solved;
+    if (threads > 1) {
+        solved = solveParallel(n, size, grid, &puzzle->stats, threads);
+    }
+    else if (options->engine == ENGINE_BITMASK && options->nogoods.bytes > 0) {
+        solved = solveWithNogoods(n, size, grid, &puzzle->stats, &options->nogoods);
+    }
+    else {
+        solved = solveWith(options->engine, n, size, grid, &puzzle->stats);
+    }
+    if (cached) {
+        int solution[size][size];
+        if (solved) {
+            applyTransform(size, &transform, grid, solution);
+        }
+        storeCache(options->cache, size, &canon[0][0], solved ? &solution[0][0] : NULL);
+    }
+    return solved;
+}
+
+extern void checkPuzzle(Puzzle *puzzle, CheckOptions const *options)
+{
+    if (puzzle->outcome != PUZZLE_UNCHECKED) {
+        return;
+    }
+    int n = puzzle->n;
+    int size = puzzle->size;
+    int (*grid)[size] = (int (*)[size]) puzzle->grid;
+    int threads = options->threads;
+    if (options->count) {
+        puzzle->solutions = countSolutions(n, size, grid, options->countLimit, &puzzle->stats,
+                                           threads);
+        puzzle->countCapped = options->countLimit > 0 &&
+                              puzzle->solutions == options->countLimit;
+        puzzle->outcome = PUZZLE_COUNTED;
+        return;
+    }
+    bool completed = true;
+    for (int i = 0; i < size * size; i++) {
+        if (puzzle->grid[i] == 0) {
+            completed = false;
+        }
+    }
+    //Determine if (in)completed, validating or solving accordingly
+    if (completed) {
+        puzzle->outcome = validateAllWithSpaces(n, size, grid) ? PUZZLE_VALID : PUZZLE_INVALID;
+    }
+    else if (solvePuzzle(puzzle, options)) {
+        puzzle->outcome = PUZZLE_SOLVED;
+    }
+    else {
+        puzzle->outcome = PUZZLE_INVALID;
+    }
+}
+
+extern void printPuzzle(Puzzle const *puzzle, FILE *out)
+{
+    switch (puzzle->outcome) {
+    case PUZZLE_VALID:
+        fprintf(out, "%s", "Valid\n");
+        break;
+    case PUZZLE_SOLVED:
+        for (int i = 0; i < puzzle->size; i++) {
+            for (int j = 0; j < puzzle->size; j++) {
+                fprintf(out, "%3d", puzzle->grid[i * puzzle->size + j]);
+            }
+            fprintf(out, "\n");
+        }
+        break;
+    case PUZZLE_COUNTED:
+        fprintf(out, "%ld%s\n", puzzle->solutions, puzzle->countCapped ? "+" : "");
+        break;
+    case PUZZLE_BAD_SIZE:
+        fprintf(out, "%s", "Invalid size\n");
+        break;
+    case PUZZLE_BAD_INPUT:
+        fprintf(out, "%s", "Invalid input\n");
+        break;
+    case PUZZLE_NO_MEMORY:
+        fprintf(out, "%s", "Out of memory\n");
+        break;
+    default:
+        fprintf(out, "%s", "Invalid\n");
+        break;
+    }
+}
+
+extern void printStats(SolveStats const *stats, FILE *out)
+{
+    fprintf(out, "Nodes: %ld\n", stats->nodes);
+    fprintf(out, "Backtracks: %ld\n", stats->backtracks);
+    fprintf(out, "Propagations: %ld\n", stats->propagations);
+    fprintf(out, "Pruned: %ld\n", stats->pruned);
+    fprintf(out, "Max depth: %d\n", stats->maxDepth);
+    fprintf(out, "Time: %.3f ms\n", stats->seconds * MILLIS);
+}
+
+extern void freePuzzle(Puzzle *puzzle)
+{
+    free(puzzle->grid);
+    puzzle->grid = NULL;
+}
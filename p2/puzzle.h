@@ -0,0 +1,139 @@
+/**
+ @file puzzle.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the puzzle component, which reads a puzzle from a stream, decides whether it needs
+ validating or solving, and prints the result.
+ */
+
+#ifndef PUZZLE_H
+#define PUZZLE_H
+
+#include "solve.h"
+#include "cache.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+/** Result of reading and checking a puzzle */
+typedef enum {
+    /** Puzzle was read but has not been checked yet */
+    PUZZLE_UNCHECKED,
+
+    /** Complete puzzle that is a correct solution */
+    PUZZLE_VALID,
+
+    /** Complete puzzle that is incorrect, or incomplete puzzle with no solution */
+    PUZZLE_INVALID,
+
+    /** Incomplete puzzle that was solved */
+    PUZZLE_SOLVED,
+
+    /** Puzzle whose solutions were counted instead of solved */
+    PUZZLE_COUNTED,
+
+    /** Puzzle size is missing or unsupported */
+    PUZZLE_BAD_SIZE,
+
+    /** Grid values are missing or out of range */
+    PUZZLE_BAD_INPUT,
+
+    /** Memory ran out before the grid could be read */
+    PUZZLE_NO_MEMORY
+} Outcome;
+
+/** How puzzles should be checked */
+typedef struct {
+    /** Engine to solve incomplete puzzles with */
+    Engine engine;
+
+    /** Number of threads to search one puzzle with; more than one searches in parallel, which
+     only the propagate engine supports */
+    int threads;
+
+    /** True to count solutions instead of validating or solving */
+    bool count;
+
+    /** Number of solutions to stop counting at, or 0 to count every solution */
+    long countLimit;
+
+    /** Cache of solutions to look incomplete puzzles up in before solving them, or NULL */
+    SolutionCache *cache;
+
+    /** Nogood table for the bitmask engine to use; a size of 0 uses none */
+    NogoodOptions nogoods;
+} CheckOptions;
+
+/** A puzzle read from input, along with the result of checking it */
+typedef struct {
+    /** Dimension of subgrids */
+    int n;
+
+    /** Dimension of entire grid */
+    int size;
+
+    /** Dynamically allocated size * size cell values in row-major order, 0 for empty */
+    int *grid;
+
+    /** Result of reading or checking this puzzle */
+    Outcome outcome;
+
+    /** Work done solving this puzzle */
+    SolveStats stats;
+
+    /** Number of solutions found, if they were counted */
+    long solutions;
+
+    /** True if counting stopped at the limit, so there may be more solutions */
+    bool countCapped;
+} Puzzle;
+
+/**
+ Finds the subgrid dimension for a grid size. Sizes must be the square of a subgrid dimension
+ from MIN_SUBGRID to MAX_SUBGRID.
+ @param size dimension of entire grid
+ @return dimension of subgrids, or 0 if the size is not supported
+ */
+int subgridFor(long size);
+
+/**
+ Reads the next puzzle from a stream. A puzzle is either a size followed by size * size
+ values, or a single 81-character line of digits with 0 or '.' for empty cells. If the puzzle
+ is malformed, its outcome is set to PUZZLE_BAD_SIZE or PUZZLE_BAD_INPUT, and if there's no
+ memory for its grid, to PUZZLE_NO_MEMORY.
+ @param fp stream to read from
+ @param puzzle filled in with the puzzle read
+ @return false if the stream had no more puzzles, true otherwise
+ */
+bool readPuzzle(FILE *fp, Puzzle *puzzle);
+
+/**
+ Validates a complete puzzle or solves an incomplete one, or counts its solutions, setting its
+ outcome. With a cache, an incomplete puzzle is put in canonical form and looked up first, and
+ only solved if it isn't found. Puzzles that were malformed are left alone.
+ @param puzzle puzzle to check
+ @param options how to check the puzzle
+ */
+void checkPuzzle(Puzzle *puzzle, CheckOptions const *options);
+
+/**
+ Prints the result of checking a puzzle: its solved grid, its number of solutions (followed by
+ a + if counting stopped at the limit), or a one-line message
+ @param puzzle puzzle to print
+ @param out stream to print to
+ */
+void printPuzzle(Puzzle const *puzzle, FILE *out);
+
+/**
+ Prints search counters, one per line: nodes, backtracks, propagations, pruned subproblems,
+ maximum depth and wall-clock time in milliseconds
+ @param stats counters to print
+ @param out stream to print to
+ */
+void printStats(SolveStats const *stats, FILE *out);
+
+/**
+ Frees the memory associated with a puzzle's grid
+ @param puzzle puzzle whose grid should be freed
+ */
+void freePuzzle(Puzzle *puzzle);
+
+#endif
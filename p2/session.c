@@ -0,0 +1,76 @@
+/**
+ @file session.c
+ @author Matthew Kierski (mdkiersk)
+ Reads editing commands and applies them to an incremental board, replying to each one.
+ */
+
+#include "session.h"
+#include "board.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+/** Longest command line read, including the newline */
+#define LINE_LEN 100
+
+extern bool runSession(Puzzle const *puzzle, FILE *in, FILE *out)
+{
+    int size = puzzle->size;
+    Board *board = newBoard(size);
+    if (!board) {
+        return false;
+    }
+    for (int i = 0; i < size * size; i++) {
+        placeDigit(board, i / size, i % size, puzzle->grid[i]);
+    }
+
+    char line[LINE_LEN + 1];
+    while (fgets(line, sizeof(line), in)) {
+        char command[LINE_LEN + 1];
+        if (sscanf(line, "%100s", command) != 1) {
+            continue;
+        }
+        int row, col, digit;
+        char extra;
+        if (strcmp(command, "place") == 0 &&
+            sscanf(line, "%*s %d %d %d %c", &row, &col, &digit, &extra) == 3 &&
+            digit > 0 && placeDigit(board, row - 1, col - 1, digit)) {
+            fprintf(out, "%s\n", cellConflicts(board, row - 1, col - 1) ? "Conflict" : "OK");
+        }
+        else if (strcmp(command, "clear") == 0 &&
+                 sscanf(line, "%*s %d %d %c", &row, &col, &extra) == 2 &&
+                 placeDigit(board, row - 1, col - 1, 0)) {
+            fprintf(out, "OK\n");
+        }
+        else if (strcmp(command, "check") == 0) {
+            BoardState state = boardState(board);
+            fprintf(out, "%s\n", state == BOARD_COMPLETE ? "Valid" :
+                    state == BOARD_INCOMPLETE ? "Incomplete" : "Conflict");
+        }
+        else if (strcmp(command, "solvable") == 0) {
+            fprintf(out, "%s\n", boardSolvable(board) ? "Solvable" : "Unsolvable");
+        }
+        else if (strcmp(command, "hint") == 0) {
+            if (boardHint(board, &row, &col, &digit)) {
+                fprintf(out, "%d %d %d\n", row + 1, col + 1, digit);
+            }
+            else {
+                fprintf(out, "No hint\n");
+            }
+        }
+        else if (strcmp(command, "print") == 0) {
+            for (int r = 0; r < size; r++) {
+                for (int c = 0; c < size; c++) {
+                    fprintf(out, "%3d", boardDigit(board, r, c));
+                }
+                fprintf(out, "\n");
+            }
+        }
+        else {
+            fprintf(out, "Invalid command\n");
+        }
+        fflush(out);
+    }
+    freeBoard(board);
+    return true;
+}
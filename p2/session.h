@@ -0,0 +1,32 @@
+/**
+ @file session.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the session component, which lets a front end edit a puzzle one command at a time
+ on an incremental board instead of starting the program again for every change.
+ */
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "puzzle.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+/**
+ Loads a puzzle onto a board, then reads commands one per line until the end of input,
+ printing a one-line reply to each (or the grid, for print). Rows and columns count from 1.
+   place ROW COL DIGIT   puts a digit in a cell: "OK", or "Conflict" if it repeats a digit
+   clear ROW COL         empties a cell: "OK"
+   check                 "Valid", "Incomplete" or "Conflict"
+   solvable              "Solvable" or "Unsolvable"
+   hint                  "ROW COL DIGIT" for a good next move, or "No hint"
+   print                 the grid, in the same format as a solved puzzle
+ Anything else gets "Invalid command".
+ @param puzzle well-formed puzzle to start from
+ @param in stream of commands
+ @param out stream for replies
+ @return false if the board couldn't be created, true otherwise
+ */
+bool runSession(Puzzle const *puzzle, FILE *in, FILE *out);
+
+#endif
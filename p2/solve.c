@@ -5,70 +5,250 @@
  verifying whether a given Sudoku grid is solvable, and if so, will solve it.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "solve.h"
 #include "validate.h"
+#include "mask.h"
+#include "propagate.h"
+#include "dlx.h"
+#include "layout.h"
+#include "nogood.h"
+#include "util.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
 
-// Value for traversing index array
-#define INDEX_INCREMENT 2
+/** Fewest search nodes a subproblem must take to rule out before it is recorded as a nogood */
+#define NOGOOD_MIN_NODES 256
 
-extern bool solve(int n, int size, int grid[size][size])
+/**
+ Solves a grid by backtracking over the empty cells in row-major order, trying digits from
+ smallest to largest. Candidates come from per-row, per-column and per-subgrid masks that are
+ updated in constant time whenever a digit is placed or removed. The search works on a packed
+ copy of the grid and looks each cell's units up in the grid's layout. With a nogood table,
+ a cell whose digits all fail after a long enough search records the state it was reached in,
+ and a cell reached in a recorded state is backed out of without trying any digit. Only
+ depths where something was recorded are looked up, which keeps lookups off the deep levels
+ where most nodes are.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, filled in with the solution if one is found
+ @param stats counters to add this search's work to
+ @param nogoods table of states known to have no solution, or NULL for none
+ @return true if solved, false otherwise
+ */
+static bool solveBitmask(int n, int size, int grid[size][size], SolveStats *stats,
+                         NogoodTable *nogoods)
 {
-    //Check to see how many empty cells exist so we can initialize array
-    int numOfEmpty = 0;
+    Layout const *layout = layoutFor(n);
+    int cells = layout->cells;
+    uint8_t values[cells];
+    packGrid(size, grid, values);
+
+    //Digits already used in each row, column and subgrid
+    Mask rowUsed[size];
+    Mask colUsed[size];
+    Mask boxUsed[size];
     for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            if (grid[i][j] == 0) {
-                numOfEmpty++;
-            }
-        }
+        rowUsed[i] = colUsed[i] = boxUsed[i] = 0;
     }
-    
-    //Make new array and fill with the empty positions from 2D array
-    int emptyCells[numOfEmpty + numOfEmpty];
-    int emptySize = 0;
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            if (grid[i][j] == 0) {
-                emptyCells[emptySize] = i;
-                emptyCells[emptySize + 1] = j;
-                emptySize = emptySize + INDEX_INCREMENT;
-            }
+
+    //Record the givens and the empty positions, rejecting givens that already conflict
+    uint16_t emptyCells[cells];
+    int numOfEmpty = 0;
+    for (int cell = 0; cell < cells; cell++) {
+        if (values[cell] == 0) {
+            emptyCells[numOfEmpty++] = cell;
+            continue;
+        }
+        Mask bit = digitBit(values[cell]);
+        int row = layout->row[cell];
+        int col = layout->col[cell];
+        int box = layout->box[cell];
+        if ((rowUsed[row] | colUsed[col] | boxUsed[box]) & bit) {
+            return false;
         }
+        rowUsed[row] |= bit;
+        colUsed[col] |= bit;
+        boxUsed[box] |= bit;
     }
 
-    //Attempt to solve grid, returning false if impossible
+    //Fill the empty cells in order, trying digits from smallest to largest and backing up
+    //when a cell runs out of candidates
+    Mask full = fullMask(size);
+    Mask remaining[numOfEmpty + 1];
     int index = 0;
-    int lastAdded = 0;
-    for (int i = 1; i <= size; i++) {
-        if (numOfEmpty == 0) {
-            break;
+    bool advancing = true;
+    //Zobrist hash of the digits placed so far in every unit, which with the index decides
+    //everything the rest of the search does
+    uint64_t hash = 0;
+    uint64_t const *keys = nogoods ? nogoodKeys(nogoods) : NULL;
+    //Nodes visited before reaching each index, and whether any nogood was recorded there
+    long entered[numOfEmpty + 1];
+    bool recorded[numOfEmpty + 1];
+    memset(recorded, 0, sizeof(recorded));
+    while (index < numOfEmpty) {
+        int cell = emptyCells[index];
+        int row = layout->row[cell];
+        int col = layout->col[cell];
+        int box = layout->box[cell];
+        if (advancing) {
+            remaining[index] = full & ~(rowUsed[row] | colUsed[col] | boxUsed[box]);
+            entered[index] = stats->nodes;
+            if (recorded[index] && remaining[index] != 0 && findNogood(nogoods, hash, index)) {
+                stats->pruned++;
+                remaining[index] = 0;
+            }
         }
-        grid[emptyCells[index]][emptyCells[index + 1]] = i;
-        if (validateAllWithSpaces(n, size, grid)) {
-            index = index + INDEX_INCREMENT;
-            numOfEmpty--;
-            lastAdded = i;
-            i = 0;
+        else {
+            //Undo the digit we placed here last time before trying the next one
+            stats->backtracks++;
+            Mask bit = digitBit(values[cell]);
+            rowUsed[row] ^= bit;
+            colUsed[col] ^= bit;
+            boxUsed[box] ^= bit;
+            if (keys) {
+                hash ^= keys[cell * (size + 1) + values[cell]];
+            }
+            values[cell] = 0;
+            //Only states that took a real search to rule out are worth the memory traffic
+            if (nogoods && remaining[index] == 0 &&
+                stats->nodes - entered[index] >= NOGOOD_MIN_NODES) {
+                addNogood(nogoods, hash, index);
+                recorded[index] = true;
+            }
         }
-        else if (!validateAllWithSpaces(n, size, grid) && i == size && index != 0) {
-            grid[emptyCells[index]][emptyCells[index + 1]] = 0;
-            index = index - INDEX_INCREMENT;
-            numOfEmpty++;
-            i = lastAdded;
-            if (lastAdded >= size) {
+        if (remaining[index] == 0) {
+            if (index == 0) {
                 return false;
             }
+            index--;
+            advancing = false;
+            continue;
         }
-        else if (!validateAllWithSpaces(n, size, grid) && i == size && index == 0) {
-            return false;
+        Mask bit = lowestBit(remaining[index]);
+        remaining[index] ^= bit;
+        stats->nodes++;
+        values[cell] = bitDigit(bit);
+        rowUsed[row] |= bit;
+        colUsed[col] |= bit;
+        boxUsed[box] |= bit;
+        if (keys) {
+            hash ^= keys[cell * (size + 1) + values[cell]];
         }
+        index++;
+        advancing = true;
+        if (index > stats->maxDepth) {
+            stats->maxDepth = index;
+        }
+    }
+    unpackGrid(size, values, grid);
+    return true;
+}
+
+extern bool solve(int n, int size, int grid[size][size])
+{
+    return solveWith(ENGINE_PROPAGATE, n, size, grid, NULL);
+}
+
+extern bool solveWith(Engine engine, int n, int size, int grid[size][size], SolveStats *stats)
+{
+    SolveStats unused;
+    if (!stats) {
+        stats = &unused;
+    }
+    *stats = (SolveStats) { 0 };
+    double start = now();
+    bool solved;
+    if (engine == ENGINE_BITMASK) {
+        solved = solveBitmask(n, size, grid, stats, NULL);
+    }
+    else if (engine == ENGINE_DLX) {
+        solved = solveDlx(n, size, grid, stats);
+    }
+    else {
+        solved = solvePropagate(n, size, grid, stats);
+    }
+    stats->seconds = now() - start;
+    return solved;
+}
+
+extern bool solveWithNogoods(int n, int size, int grid[size][size], SolveStats *stats,
+                             NogoodOptions const *nogoods)
+{
+    SolveStats unused;
+    if (!stats) {
+        stats = &unused;
+    }
+    *stats = (SolveStats) { 0 };
+    double start = now();
+    //Without room for a table, the search just runs without one
+    NogoodTable *table = newNogoodTable(n, nogoods);
+    bool solved = solveBitmask(n, size, grid, stats, table);
+    freeNogoodTable(table);
+    stats->seconds = now() - start;
+    return solved;
+}
+
+extern bool solveParallel(int n, int size, int grid[size][size], SolveStats *stats, int threads)
+{
+    SolveStats unused;
+    if (!stats) {
+        stats = &unused;
+    }
+    *stats = (SolveStats) { 0 };
+    double start = now();
+    bool solved = solvePropagateParallel(n, size, grid, stats, threads);
+    stats->seconds = now() - start;
+    return solved;
+}
+
+extern long countSolutions(int n, int size, int grid[size][size], long limit, SolveStats *stats,
+                           int threads)
+{
+    SolveStats unused;
+    if (!stats) {
+        stats = &unused;
+    }
+    *stats = (SolveStats) { 0 };
+    double start = now();
+    long count = countPropagate(n, size, grid, stats, threads, limit > 0 ? limit : LONG_MAX);
+    stats->seconds = now() - start;
+    return count;
+}
+
+extern void addStats(SolveStats *total, SolveStats const *part)
+{
+    total->nodes += part->nodes;
+    total->backtracks += part->backtracks;
+    total->propagations += part->propagations;
+    total->pruned += part->pruned;
+    if (part->maxDepth > total->maxDepth) {
+        total->maxDepth = part->maxDepth;
+    }
+    total->seconds += part->seconds;
+}
+
+extern bool parseEngine(char const *name, Engine *engine)
+{
+    if (strcmp(name, "propagate") == 0) {
+        *engine = ENGINE_PROPAGATE;
+    }
+    else if (strcmp(name, "bitmask") == 0) {
+        *engine = ENGINE_BITMASK;
+    }
+    else if (strcmp(name, "dlx") == 0) {
+        *engine = ENGINE_DLX;
+    }
+    else {
+        return false;
     }
     return true;
 }
 
 extern bool validateAllWithSpaces(int n, int size, int grid[size][size])
 {
-    return validateRowsWithSpaces(size, grid) && validateColsWithSpaces(size, grid) &&
-        validateSquaresWithSpaces(n, size, grid);
+    return validateGrid(n, size, grid);
 }
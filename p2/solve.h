@@ -5,8 +5,71 @@ This serves as the header file in the solve component. This component is respons
 verifying whether a given Sudoku grid is solvable, and if so, will solve it.
 */
 
+#ifndef SOLVE_H
+#define SOLVE_H
+
 #include <stdbool.h>
 
+/** Smallest supported subgrid dimension */
+#define MIN_SUBGRID 2
+
+/** Largest supported subgrid dimension, giving 49x49 grids */
+#define MAX_SUBGRID 7
+
+/** Search engines that can be used to solve a grid */
+typedef enum {
+    /** Constraint propagation with minimum-remaining-values branching (the default) */
+    ENGINE_PROPAGATE,
+
+    /** Plain backtracking over bitmask candidates in row-major order */
+    ENGINE_BITMASK,
+
+    /** Exact cover search with dancing links */
+    ENGINE_DLX
+} Engine;
+
+/** Which entry the nogood table gives up when a new nogood lands in a full slot */
+typedef enum {
+    /** Keep whichever nogood is closest to the root of the search, since it rules out the
+     most work (the default) */
+    REPLACE_SHALLOW,
+
+    /** Always keep the newest nogood, dropping the oldest */
+    REPLACE_RECENT
+} Replacement;
+
+/** Settings for the bitmask engine's table of subproblems known to have no solution */
+typedef struct {
+    /** Memory the table may use, in bytes, or 0 for no table */
+    long bytes;
+
+    /** Which entry to give up when a slot is full */
+    Replacement replace;
+} NogoodOptions;
+
+/** Counters describing the work done while solving a grid */
+typedef struct {
+    /** Number of search nodes visited, i.e. tentative digits placed while searching */
+    long nodes;
+
+    /** Number of tentative digits that were taken back again */
+    long backtracks;
+
+    /** Number of placed digits removed from their peers' candidates by deduction (only the
+     propagate engine deduces) */
+    long propagations;
+
+    /** Number of subproblems skipped because the nogood table already knew they had no
+     solution (only the bitmask engine keeps a nogood table) */
+    long pruned;
+
+    /** Greatest number of tentative digits in place at once */
+    int maxDepth;
+
+    /** Wall-clock time spent, in seconds */
+    double seconds;
+} SolveStats;
+
 /**
  Attempts to solve a given, incomplete Sudoku grid.
  @param n dimension of subgrids
@@ -16,6 +79,75 @@ verifying whether a given Sudoku grid is solvable, and if so, will solve it.
 */
 bool solve(int n, int size, int grid[size][size]);
 
+/**
+ Attempts to solve a given, incomplete Sudoku grid using the given engine, recording how
+ much searching it took.
+ @param engine engine to solve with
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, filled in with the solution if one is found
+ @param stats counters to fill in, or NULL if they aren't needed
+ @return true if solved, false otherwise
+*/
+bool solveWith(Engine engine, int n, int size, int grid[size][size], SolveStats *stats);
+
+/**
+ Attempts to solve a given, incomplete Sudoku grid with the bitmask engine, remembering the
+ subproblems it proves to have no solution so it never searches them twice. A subproblem is
+ identified by a Zobrist hash of the digits used in every row, column and subgrid, which is
+ all the rest of the search depends on, so the same subproblem reached through different
+ earlier choices is pruned.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, filled in with the solution if one is found
+ @param stats counters to fill in, or NULL if they aren't needed
+ @param nogoods size and replacement policy of the table
+ @return true if solved, false otherwise
+*/
+bool solveWithNogoods(int n, int size, int grid[size][size], SolveStats *stats,
+                      NogoodOptions const *nogoods);
+
+/**
+ Attempts to solve a given, incomplete Sudoku grid with the propagate engine's search spread
+ over several threads. When the puzzle has a unique solution, the result is the same as solve's.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, filled in with the solution if one is found
+ @param stats counters to fill in with the work of every thread, or NULL if they aren't needed
+ @param threads number of worker threads
+ @return true if solved, false otherwise
+*/
+bool solveParallel(int n, int size, int grid[size][size], SolveStats *stats, int threads);
+
+/**
+ Counts the solutions of a given Sudoku grid with the propagate engine's search, stopping as
+ soon as the limit is reached, so a limit of 2 is enough to tell whether a puzzle is unique.
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param grid 2D array representing Sudoku grid, left unchanged
+ @param limit number of solutions to stop counting at, or 0 to count every solution
+ @param stats counters to fill in with the work of every thread, or NULL if they aren't needed
+ @param threads number of worker threads; more than one shares the search tree among them
+ @return number of solutions, at most limit
+*/
+long countSolutions(int n, int size, int grid[size][size], long limit, SolveStats *stats,
+                    int threads);
+
+/**
+ Adds the work in one set of counters to another. Depths are combined by taking the larger.
+ @param total counters to add to
+ @param part counters to add
+*/
+void addStats(SolveStats *total, SolveStats const *part);
+
+/**
+ Looks up an engine by the name used for it on the command line
+ @param name name of the engine: "propagate", "bitmask" or "dlx"
+ @param engine set to the matching engine if one is found
+ @return true if the name matched an engine, false otherwise
+*/
+bool parseEngine(char const *name, Engine *engine);
+
 /**
 Helper method to evaluate all validations at once
 @param n size of subgrid
@@ -24,3 +156,5 @@ Helper method to evaluate all validations at once
 @return true if all validation tests pass, false otherwise
 */
 bool validateAllWithSpaces(int n, int size, int grid[size][size]);
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ @file steal.c
+ @author Matthew Kierski (mdkiersk)
+ Implements the work-stealing deque. Tasks are coarse (whole subtrees of a search), so a lock
+ per deque costs little next to the work each task does.
+ */
+
+#include "steal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/** Initial capacity of a deque */
+#define INITIAL_CAP 16
+
+extern bool initDeque(Deque *deque)
+{
+    deque->capacity = INITIAL_CAP;
+    deque->items = malloc(sizeof(void *) * deque->capacity);
+    deque->top = 0;
+    deque->bottom = 0;
+    pthread_mutex_init(&deque->lock, NULL);
+    return deque->items != NULL;
+}
+
+extern void freeDeque(Deque *deque)
+{
+    free(deque->items);
+    pthread_mutex_destroy(&deque->lock);
+}
+
+extern bool pushBottom(Deque *deque, void *task)
+{
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom == deque->capacity) {
+        //Slide live tasks down over stolen slots, growing only if that doesn't free any room
+        int live = deque->bottom - deque->top;
+        if (deque->top > 0) {
+            memmove(deque->items, deque->items + deque->top, sizeof(void *) * live);
+        }
+        else {
+            void **items = realloc(deque->items, sizeof(void *) * deque->capacity * 2);
+            if (!items) {
+                pthread_mutex_unlock(&deque->lock);
+                return false;
+            }
+            deque->items = items;
+            deque->capacity *= 2;
+        }
+        deque->top = 0;
+        deque->bottom = live;
+    }
+    deque->items[deque->bottom++] = task;
+    pthread_mutex_unlock(&deque->lock);
+    return true;
+}
+
+extern void *popBottom(Deque *deque)
+{
+    void *task = NULL;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top) {
+        task = deque->items[--deque->bottom];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return task;
+}
+
+extern void *stealTop(Deque *deque)
+{
+    void *task = NULL;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top) {
+        task = deque->items[deque->top++];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return task;
+}
@@ -0,0 +1,69 @@
+/**
+ @file steal.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the steal component, a double-ended task queue for work stealing. Each worker
+ thread owns one deque: the owner pushes and pops tasks at the bottom, so it works on the
+ newest (deepest) task first, while idle threads steal the oldest task from the top.
+ */
+
+#ifndef STEAL_H
+#define STEAL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+/** Work-stealing deque of task pointers */
+typedef struct {
+    /** Dynamically allocated array of tasks, with live tasks from top to bottom - 1 */
+    void **items;
+
+    /** Capacity of the items array */
+    int capacity;
+
+    /** Index of the oldest task, where thieves steal */
+    int top;
+
+    /** Index one past the newest task, where the owner pushes and pops */
+    int bottom;
+
+    /** Lock protecting the deque */
+    pthread_mutex_t lock;
+} Deque;
+
+/**
+ Initializes an empty deque. Even if it fails, the deque can still be passed to freeDeque.
+ @param deque deque to initialize
+ @return false if memory ran out, true otherwise
+ */
+bool initDeque(Deque *deque);
+
+/**
+ Frees the memory used by a deque. Tasks still in the deque are not freed.
+ @param deque deque to free
+ */
+void freeDeque(Deque *deque);
+
+/**
+ Adds a task at the owner's end of a deque
+ @param deque deque to add to
+ @param task task to add
+ @return false if the deque was full and memory ran out growing it, leaving the task out,
+ true otherwise
+ */
+bool pushBottom(Deque *deque, void *task);
+
+/**
+ Removes the newest task from the owner's end of a deque
+ @param deque deque to take from
+ @return the task, or NULL if the deque is empty
+ */
+void *popBottom(Deque *deque);
+
+/**
+ Removes the oldest task from the thieves' end of a deque
+ @param deque deque to steal from
+ @return the task, or NULL if the deque is empty
+ */
+void *stealTop(Deque *deque);
+
+#endif
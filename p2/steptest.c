@@ -0,0 +1,178 @@
+/**
+ @file steptest.c
+ @author Matthew Kierski (mdkiersk)
+ Tests stepping a search through libsudoku. Each puzzle read from standard input, in the size
+ and grid format, is solved by stepping it a few nodes at a time and then has every solution
+ enumerated by stepping again after each one, both without a budget and with one. A line is
+ printed for each, and the program fails if a step goes over its budget, a budgeted search
+ finds a different solution than sudokuSolve, a solution breaks a rule or changes a given, the
+ same solution is found twice, or the two enumerations find different numbers of solutions.
+ */
+
+#include "libsudoku.h"
+#include "validate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+//Number of nodes each budgeted step may visit
+#define BUDGET 5
+
+/** Size of the grids being compared by compareGrids */
+static int gridCells;
+
+/**
+ Orders two grids by their cells, for sorting solutions
+ @param a first grid
+ @param b second grid
+ @return negative, zero or positive as a comes before, equals or comes after b
+ */
+static int compareGrids(void const *a, void const *b)
+{
+    return memcmp(a, b, sizeof(int) * gridCells);
+}
+
+/**
+ Checks that a solution fills every cell, keeps the puzzle's givens and breaks no rule
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param puzzle size * size cells of the puzzle
+ @param solution size * size cells of the solution
+ @return true if the solution solves the puzzle, false otherwise
+ */
+static bool solves(int n, int size, int const *puzzle, int *solution)
+{
+    for (int i = 0; i < size * size; i++) {
+        if (solution[i] == 0 || (puzzle[i] != 0 && puzzle[i] != solution[i])) {
+            return false;
+        }
+    }
+    return validateGrid(n, size, (int (*)[size]) solution);
+}
+
+/**
+ Steps a puzzle a few nodes at a time until it is solved, and checks that no step goes over
+ its budget and that the solution is the one sudokuSolve finds
+ @param ctx context to solve with
+ @param size dimension of entire grid
+ @param puzzle size * size cells of the puzzle
+ @return true if every step kept to its budget and the solutions match, false otherwise
+ */
+static bool stepToSolution(SudokuContext *ctx, int size, int const *puzzle)
+{
+    int cells = size * size;
+    int stepped[cells];
+    int solved[cells];
+    int steps = 0;
+    long nodes = 0;
+    bool kept = true;
+    SudokuStatus status = sudokuLoad(ctx, puzzle);
+    while (status == SUDOKU_RUNNING) {
+        status = sudokuStep(ctx, BUDGET);
+        steps++;
+        kept = kept && sudokuStats(ctx)->nodes - nodes <= BUDGET;
+        nodes = sudokuStats(ctx)->nodes;
+    }
+    bool found = sudokuSolution(ctx, stepped);
+    memcpy(solved, puzzle, sizeof(int) * cells);
+    bool same = sudokuSolve(ctx, solved) == SUDOKU_SOLVED ? found &&
+                memcmp(stepped, solved, sizeof(int) * cells) == 0 : !found;
+    printf("Budget %d: %s after %d steps and %ld nodes, %s, %s sudokuSolve\n", BUDGET,
+           found ? "solved" : "no solution", steps, nodes,
+           kept ? "within budget" : "OVER BUDGET", same ? "same as" : "DIFFERENT FROM");
+    return kept && same;
+}
+
+/**
+ Enumerates every solution of a puzzle by stepping again after each one is found
+ @param ctx context to solve with
+ @param n dimension of subgrids
+ @param size dimension of entire grid
+ @param puzzle size * size cells of the puzzle
+ @param budget most nodes for each step, or 0 for no limit
+ @return number of solutions, or -1 if one was wrong, repeated or memory ran out
+ */
+static long enumerate(SudokuContext *ctx, int n, int size, int const *puzzle, long budget)
+{
+    int cells = size * size;
+    long count = 0;
+    long capacity = 0;
+    int *solutions = NULL;
+    bool correct = true;
+    SudokuStatus status = sudokuLoad(ctx, puzzle);
+    while (correct && status != SUDOKU_UNSOLVABLE && status != SUDOKU_BAD_INPUT) {
+        status = sudokuStep(ctx, budget);
+        if (status != SUDOKU_SOLVED) {
+            continue;
+        }
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : cells;
+            int *grown = realloc(solutions, sizeof(int) * cells * capacity);
+            if (!grown) {
+                free(solutions);
+                return -1;
+            }
+            solutions = grown;
+        }
+        int *solution = solutions + count * cells;
+        sudokuSolution(ctx, solution);
+        correct = solves(n, size, puzzle, solution);
+        count++;
+    }
+
+    //Sorting puts any solution found twice next to itself
+    gridCells = cells;
+    qsort(solutions, count, sizeof(int) * cells, compareGrids);
+    for (long i = 1; correct && i < count; i++) {
+        correct = compareGrids(solutions + (i - 1) * cells, solutions + i * cells) != 0;
+    }
+    free(solutions);
+    return correct ? count : -1;
+}
+
+/**
+ Starting point of the program. Reads each puzzle and tests stepping it.
+ @return exit status, 1 if any test fails or a puzzle can't be read
+ */
+int main(void)
+{
+    int status = EXIT_SUCCESS;
+    int size;
+    for (int number = 1; scanf("%d", &size) == 1; number++) {
+        SudokuContext *ctx = sudokuCreate(size);
+        int *puzzle = malloc(sizeof(int) * size * size);
+        if (!ctx || !puzzle) {
+            fprintf(stderr, "Can't solve puzzles of size %d\n", size);
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < size * size; i++) {
+            if (scanf("%d", &puzzle[i]) != 1) {
+                fprintf(stderr, "Invalid input\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        int n = 1;
+        while (n * n < size) {
+            n++;
+        }
+
+        printf("Puzzle %d\n", number);
+        if (!stepToSolution(ctx, size, puzzle)) {
+            status = EXIT_FAILURE;
+        }
+        long unlimited = enumerate(ctx, n, size, puzzle, 0);
+        long budgeted = enumerate(ctx, n, size, puzzle, BUDGET);
+        if (unlimited < 0 || budgeted < 0 || unlimited != budgeted) {
+            printf("Enumeration FAILED: %ld solutions with no budget, %ld with budget %d\n",
+                   unlimited, budgeted, BUDGET);
+            status = EXIT_FAILURE;
+        }
+        else {
+            printf("Solutions: %ld with no budget and with budget %d\n", unlimited, BUDGET);
+        }
+        free(puzzle);
+        sudokuDestroy(ctx);
+    }
+    return status;
+}
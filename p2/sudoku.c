@@ -8,87 +8,261 @@ necessary.
 
 #include "solve.h"
 #include "validate.h"
+#include "puzzle.h"
+#include "batch.h"
+#include "pool.h"
+#include "generate.h"
+#include "session.h"
+#include "cache.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
-// Proepr size for 4X4 grid
-#define FOURXFOUR 4
-//Proper size for 9x9 grid
-#define NINEXNINE 9
-//Proper size for 16x16 grid
-#define SIXTEENXSIXTEEN 16
-//Proper dimension of 4x4 subgrid
-#define TWO_SUBGRID 2
-//Proper dimension of 9x9 subgrid
-#define NINE_SUBGRID 3
-//Proper dimension of 16x16 subgrid
-#define SIXTEEN_SUBGRID 4
+#include <string.h>
+//Prefix of the command-line option that selects an engine
+#define ENGINE_OPTION "--engine="
+//Command-line option that turns on batch mode, optionally followed by =file
+#define BATCH_OPTION "--batch"
+//Command-line option that turns on counting solutions, optionally followed by =limit
+#define COUNT_OPTION "--count"
+//Number of solutions counting stops at by default, enough to tell whether a puzzle is unique
+#define DEFAULT_COUNT_LIMIT 2
+//Prefix of the command-line option that turns on generating puzzles of the given size
+#define GENERATE_OPTION "--generate="
+//Prefix of the command-line option that sets the number of clues in generated puzzles
+#define CLUES_OPTION "--clues="
+//Prefix of the command-line option that seeds puzzle generation
+#define SEED_OPTION "--seed="
+//Prefix of the command-line option that sets the number of puzzles to generate
+#define PUZZLES_OPTION "--puzzles="
+//Command-line option that turns on the solution cache, optionally followed by =file to keep it in
+#define CACHE_OPTION "--cache"
+//Prefix of the command-line option that sets the number of puzzles the cache holds
+#define CACHE_SIZE_OPTION "--cache-size="
+//Number of puzzles the cache holds by default
+#define DEFAULT_CACHE_SIZE 10000
+//Prefix of the command-line option that gives the bitmask engine a nogood table of this many MB
+#define NOGOODS_OPTION "--nogoods="
+//Prefix of the command-line option that sets the nogood table's replacement policy
+#define NOGOOD_POLICY_OPTION "--nogood-policy="
+//Bytes in a megabyte
+#define MEGABYTE (1024L * 1024L)
+//Prefix of the command-line option that sets the number of threads
+#define THREADS_OPTION "--threads="
+//Command-line usage message
+#define USAGE "usage: sudoku [--engine=propagate|bitmask|dlx] [--stats] [--count[=limit]] " \
+    "[--batch[=puzzles.txt] | --parallel] [--threads=n]\n" \
+    "              [--cache[=cache.txt]] [--cache-size=n] [--nogoods=mb] " \
+    "[--nogood-policy=shallow|recent]\n" \
+    "       sudoku --interactive\n" \
+    "       sudoku --generate=size [--clues=k] [--seed=s] [--puzzles=count] [--threads=n]\n"
 
 /**
  The starting point of our program. Main will read in the input, creating a new array of the
  desired size. It will then check to see if the grid is complete. If so, it will validate the grid,
  printing "Valid" if correct or "Invalid" if not. If the grid is incomplete, it will attempt to
  solve it. If solved, it will print the result to output, and if unable to be solved, it will
- print "Invalid" to output.
+ print "Invalid" to output. When counting, it prints the number of solutions instead. In batch
+ mode, it does the same for every puzzle in the input. With the cache, puzzles equivalent to ones
+ already solved are answered without solving them again. In generate mode, it prints new puzzles
+ instead of reading any, and in interactive mode it reads editing commands after the puzzle.
+ @param argc number of command line arguments
+ @param argv command line arguments, selecting the engine, whether to report search stats,
+ whether to count solutions, whether to run in batch mode and what puzzles to generate
  @return exit status
  */
-int main()
+int main(int argc, char *argv[])
 {
-    int size = 0;
-    scanf( "%d", &size);
-    //Ensure size is valid
-    if (size != FOURXFOUR && size != NINEXNINE && size != SIXTEENXSIXTEEN) {
-        printf("%s", "Invalid size\n");
+    //Read options
+    CheckOptions options = { ENGINE_PROPAGATE, 1, false, DEFAULT_COUNT_LIMIT, NULL,
+                             { 0, REPLACE_SHALLOW } };
+    bool reportStats = false;
+    bool batch = false;
+    bool parallel = false;
+    bool interactive = false;
+    char const *batchFile = NULL;
+    int threads = defaultThreads();
+    int generateSize = 0;
+    int clues = 0;
+    unsigned long seed = 1;
+    long puzzles = 1;
+    bool useCache = false;
+    char const *cacheFile = NULL;
+    long cacheSize = DEFAULT_CACHE_SIZE;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], ENGINE_OPTION, strlen(ENGINE_OPTION)) == 0 &&
+            parseEngine(argv[i] + strlen(ENGINE_OPTION), &options.engine)) {
+            continue;
+        }
+        if (strcmp(argv[i], "--stats") == 0) {
+            reportStats = true;
+            continue;
+        }
+        if (strncmp(argv[i], BATCH_OPTION, strlen(BATCH_OPTION)) == 0) {
+            char const *rest = argv[i] + strlen(BATCH_OPTION);
+            if (*rest == '\0' || (*rest == '=' && rest[1] != '\0')) {
+                batch = true;
+                batchFile = *rest == '=' ? rest + 1 : NULL;
+                continue;
+            }
+        }
+        if (strncmp(argv[i], COUNT_OPTION, strlen(COUNT_OPTION)) == 0) {
+            char const *rest = argv[i] + strlen(COUNT_OPTION);
+            char *end = NULL;
+            if (*rest == '=' && rest[1] != '\0') {
+                options.countLimit = strtol(rest + 1, &end, 10);
+            }
+            if (*rest == '\0' || (end && *end == '\0' && options.countLimit >= 0)) {
+                options.count = true;
+                continue;
+            }
+        }
+        if (strncmp(argv[i], CACHE_SIZE_OPTION, strlen(CACHE_SIZE_OPTION)) == 0) {
+            cacheSize = atol(argv[i] + strlen(CACHE_SIZE_OPTION));
+            if (cacheSize > 0) {
+                continue;
+            }
+        }
+        if (strncmp(argv[i], CACHE_OPTION, strlen(CACHE_OPTION)) == 0) {
+            char const *rest = argv[i] + strlen(CACHE_OPTION);
+            if (*rest == '\0' || (*rest == '=' && rest[1] != '\0')) {
+                useCache = true;
+                cacheFile = *rest == '=' ? rest + 1 : NULL;
+                continue;
+            }
+        }
+        if (strncmp(argv[i], NOGOODS_OPTION, strlen(NOGOODS_OPTION)) == 0) {
+            long megabytes = atol(argv[i] + strlen(NOGOODS_OPTION));
+            options.nogoods.bytes = megabytes * MEGABYTE;
+            if (megabytes > 0) {
+                continue;
+            }
+        }
+        if (strncmp(argv[i], NOGOOD_POLICY_OPTION, strlen(NOGOOD_POLICY_OPTION)) == 0) {
+            char const *policy = argv[i] + strlen(NOGOOD_POLICY_OPTION);
+            if (strcmp(policy, "shallow") == 0 || strcmp(policy, "recent") == 0) {
+                options.nogoods.replace = *policy == 's' ? REPLACE_SHALLOW : REPLACE_RECENT;
+                continue;
+            }
+        }
+        if (strcmp(argv[i], "--interactive") == 0) {
+            interactive = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--parallel") == 0) {
+            parallel = true;
+            continue;
+        }
+        if (strncmp(argv[i], GENERATE_OPTION, strlen(GENERATE_OPTION)) == 0) {
+            generateSize = atoi(argv[i] + strlen(GENERATE_OPTION));
+            if (subgridFor(generateSize) != 0) {
+                continue;
+            }
+        }
+        if (strncmp(argv[i], CLUES_OPTION, strlen(CLUES_OPTION)) == 0) {
+            clues = atoi(argv[i] + strlen(CLUES_OPTION));
+            if (clues > 0) {
+                continue;
+            }
+        }
+        if (strncmp(argv[i], SEED_OPTION, strlen(SEED_OPTION)) == 0) {
+            char *end;
+            seed = strtoul(argv[i] + strlen(SEED_OPTION), &end, 10);
+            if (*end == '\0' && end != argv[i] + strlen(SEED_OPTION)) {
+                continue;
+            }
+        }
+        if (strncmp(argv[i], PUZZLES_OPTION, strlen(PUZZLES_OPTION)) == 0) {
+            puzzles = atol(argv[i] + strlen(PUZZLES_OPTION));
+            if (puzzles > 0) {
+                continue;
+            }
+        }
+        if (strncmp(argv[i], THREADS_OPTION, strlen(THREADS_OPTION)) == 0) {
+            threads = atoi(argv[i] + strlen(THREADS_OPTION));
+            if (threads > 0) {
+                continue;
+            }
+        }
+        fprintf(stderr, "%s", USAGE);
         return EXIT_FAILURE;
     }
-    int grid[size][size];
-    bool completed = true;
-    //Determine n
-    int n = 0;
-    if (size == FOURXFOUR) {
-        n = TWO_SUBGRID;
+    //Parallel search is only for single puzzles, and both it and counting use the propagate engine
+    bool propagateOnly = parallel || options.count;
+    //The cache holds solutions, so it is of no use when counting, and only the bitmask engine
+    //keeps nogoods
+    if ((parallel && batch) || (propagateOnly && options.engine != ENGINE_PROPAGATE) ||
+        (useCache && options.count) ||
+        (options.nogoods.bytes > 0 && options.engine != ENGINE_BITMASK)) {
+        fprintf(stderr, "%s", USAGE);
+        return EXIT_FAILURE;
     }
-    else if (size == NINEXNINE) {
-        n = NINE_SUBGRID;
+
+    if (generateSize) {
+        //Generating doesn't read puzzles, so it can't be combined with the checking options
+        if (batch || parallel || interactive || options.count || useCache ||
+            options.engine != ENGINE_PROPAGATE || clues > generateSize * generateSize) {
+            fprintf(stderr, "%s", USAGE);
+            return EXIT_FAILURE;
+        }
+        bool made = generatePuzzles(subgridFor(generateSize), clues, seed, puzzles, threads,
+                                    stdout);
+        return made ? EXIT_SUCCESS : EXIT_FAILURE;
     }
-    else {
-        n = SIXTEEN_SUBGRID;
+
+    //Interactive mode edits a single puzzle with the propagate engine
+    if (interactive && (batch || parallel || options.count || useCache ||
+                        options.engine != ENGINE_PROPAGATE)) {
+        fprintf(stderr, "%s", USAGE);
+        return EXIT_FAILURE;
     }
-    //Read input and store it into array
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            if (scanf( "%d", &grid[i][j]) != 1 || grid[i][j] < 0 || grid[i][j] > size) {
-                printf( "%s", "Invalid input\n");
-                return EXIT_FAILURE;
-            }
-            if (grid[i][j] == 0) {
-                completed = false;
-            }
+
+    if (useCache) {
+        options.cache = newCache(cacheSize);
+        if (!options.cache || (cacheFile && !loadCache(options.cache, cacheFile))) {
+            fprintf(stderr, "Can't read cache: %s\n", cacheFile ? cacheFile : "out of memory");
+            freeCache(options.cache);
+            return EXIT_FAILURE;
         }
     }
-    //Determine if (in)completed, printing proper output
-    if (completed) {
-        if (validateAllWithSpaces(n, size, grid)) {
-            printf( "%s", "Valid\n");
+
+    bool wellFormed;
+    if (batch) {
+        FILE *fp = batchFile ? fopen(batchFile, "r") : stdin;
+        if (!fp) {
+            fprintf(stderr, "Can't open file: %s\n", batchFile);
+            freeCache(options.cache);
+            return EXIT_FAILURE;
         }
-        else {
-            printf( "%s", "Invalid\n");
+        wellFormed = runBatch(fp, &options, threads, reportStats);
+        if (batchFile) {
+            fclose(fp);
         }
     }
     else {
-        if (solve(n, size, grid)) {
-            for (int i = 0; i < size; i++) {
-                for (int j = 0; j < size; j++) {
-                    printf( "%3d", grid[i][j]);
-                    if (j == size - 1) {
-                        printf( "\n");
-                    }
-                }
-            }
+        //Read a single puzzle, then validate or solve it
+        Puzzle puzzle;
+        if (!readPuzzle(stdin, &puzzle)) {
+            puzzle.outcome = PUZZLE_BAD_SIZE;
+        }
+        wellFormed = puzzle.outcome == PUZZLE_UNCHECKED;
+        if (interactive && wellFormed) {
+            bool started = runSession(&puzzle, stdin, stdout);
+            freePuzzle(&puzzle);
+            return started ? EXIT_SUCCESS : EXIT_FAILURE;
         }
-        else {
-            printf( "%s", "Invalid\n");
+        options.threads = parallel ? threads : 1;
+        checkPuzzle(&puzzle, &options);
+        if (reportStats && wellFormed) {
+            printStats(&puzzle.stats, stderr);
         }
+        printPuzzle(&puzzle, stdout);
+        freePuzzle(&puzzle);
+    }
+
+    if (cacheFile && !saveCache(options.cache, cacheFile)) {
+        fprintf(stderr, "Can't write cache: %s\n", cacheFile);
+        wellFormed = false;
     }
-    return EXIT_SUCCESS;
+    freeCache(options.cache);
+    return wellFormed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -5,11 +5,13 @@ FAIL=0
 runTest() {
   TESTNO=$1
   ESTATUS=$2
+  shift 2
+  ARGS="$*"
 
   rm -f output.html
 
-  echo "Test $TESTNO: ./sudoku < input-$TESTNO.txt > output.txt"
-  ./sudoku < input-$TESTNO.txt > output.txt
+  echo "Test $TESTNO: ./sudoku ${ARGS:+$ARGS }< input-$TESTNO.txt > output.txt"
+  ./sudoku $ARGS < input-$TESTNO.txt > output.txt
   STATUS=$?
 
   # Make sure the program exited with the right exit status.
@@ -30,9 +32,10 @@ runTest() {
   return 0
 }
 
-# Build the program.
+# Build the program and the libsudoku stepping test.
 make clean
 make
+make steptest
 
 # Run individual tests.
 if [ -x sudoku ] ; then
@@ -52,12 +55,50 @@ if [ -x sudoku ] ; then
     runTest 14 1
     runTest 15 1
     runTest 16 1
+    runTest 17 0
+    runTest 17 0 --engine=bitmask
+    runTest 17 0 --engine=bitmask --nogoods=1 --nogood-policy=recent
+    runTest 18 0
+    runTest 18 0 --engine=dlx
+    runTest 19 0 --batch
+    runTest 20 0
+    runTest 20 0 --engine=dlx
+    runTest 21 0
+    runTest 18 0 --parallel --threads=4
+    runTest 20 0 --parallel --threads=3
+    runTest 22 0 --count=0
+    runTest 22 0 --count=0 --parallel --threads=4
+    runTest 23 0 --count
+    runTest 24 0 --generate=9 --clues=30 --seed=5 --puzzles=2 --threads=2
+    runTest 25 0 --interactive
+    runTest 26 0 --batch --cache --threads=2
+    cp cache-27.txt cache.txt
+    runTest 27 0 --batch --cache=cache.txt
+    cp cache-28.txt cache.txt
+    runTest 28 1 --cache=cache.txt
+    rm -f cache.txt
 
 else
     echo "**** The sudoku program didn't compile successfully"
     FAIL=1
 fi
 
+# Step searches through libsudoku with and without a node budget.
+if [ -x steptest ] ; then
+    echo "Test 29: ./steptest < input-29.txt > output.txt"
+    ./steptest < input-29.txt > output.txt
+    STATUS=$?
+    if [ $STATUS -ne 0 ] || ! diff -q expected-29.txt output.txt >/dev/null 2>&1 ; then
+        echo "**** Test 29 FAILED - exit status $STATUS or output didn't match the expected output"
+        FAIL=1
+    else
+        echo "Sudoku test 29 PASS"
+    fi
+else
+    echo "**** The steptest program didn't compile successfully"
+    FAIL=1
+fi
+
 if [ $FAIL -ne 0 ]; then
   echo "**** There were failing tests"
   exit 1
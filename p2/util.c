@@ -0,0 +1,29 @@
+/**
+ @file util.c
+ @author Matthew Kierski (mdkiersk)
+ Small helpers shared by several components. The clock is monotonic, so times taken with it
+ can't go backwards when the system clock is set.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "util.h"
+#include <time.h>
+
+/** Nanoseconds in a second */
+#define NANOS 1000000000.0
+
+extern double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / NANOS;
+}
+
+extern uint64_t nextRandom(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,27 @@
+/**
+ @file util.h
+ @author Matthew Kierski (mdkiersk)
+ Header for the util component, which holds small helpers shared by several other components:
+ a monotonic clock for timing searches and a seedable random number generator.
+ */
+
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <stdint.h>
+
+/**
+ Reads the current time from a monotonic clock
+ @return time in seconds
+ */
+double now(void);
+
+/**
+ Advances a random number generator (SplitMix64) and returns its next value. The same starting
+ state always gives the same sequence of values.
+ @param state state of the generator
+ @return next pseudo-random value
+ */
+uint64_t nextRandom(uint64_t *state);
+
+#endif
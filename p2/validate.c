@@ -1,11 +1,43 @@
 /**
  @file validate.c
  @author Matthew Kierski (mdkiersk)
- A program that validates whether a given row, column, or subgrid matches Sudoku validity
+ A program that validates whether a given row, column, or subgrid matches Sudoku validity.
+ validateGrid and validateGrids use the single-pass kernel in vkernel.h, compiled here once for
+ every supported subgrid dimension, with vector instructions for grids up to 25x25.
  */
 
 #include "validate.h"
+#include "layout.h"
 #include <stdbool.h>
+#include <stdint.h>
+
+#define KERNEL_N 2
+#define KERNEL_MASK uint32_t
+#define KERNEL_SIMD
+#include "vkernel.h"
+
+#define KERNEL_N 3
+#define KERNEL_MASK uint32_t
+#define KERNEL_SIMD
+#include "vkernel.h"
+
+#define KERNEL_N 4
+#define KERNEL_MASK uint32_t
+#define KERNEL_SIMD
+#include "vkernel.h"
+
+#define KERNEL_N 5
+#define KERNEL_MASK uint32_t
+#define KERNEL_SIMD
+#include "vkernel.h"
+
+#define KERNEL_N 6
+#define KERNEL_MASK uint64_t
+#include "vkernel.h"
+
+#define KERNEL_N 7
+#define KERNEL_MASK uint64_t
+#include "vkernel.h"
 
 /**
  Helper method that checks to see if a grid, converted to a single dimensional array, is valid
@@ -56,19 +88,15 @@ extern bool validateCols(int size, int grid[size][size])
 
 extern bool validateSquares(int n, int size, int grid[size][size])
 {
+    uint16_t const *boxes = &layoutFor(n)->units[2 * size * size];
+    int const *cells = &grid[0][0];
     int convertedArray[size];
-    int convertedSize = 0;
-    for (int i = 0; i <= size - n; i = i + n) {
-        for (int j = 0; j <= size - n; j = j + n) {
-            for (int k = i; k < i + n; k++) {
-                for (int m = j; m < j + n; m++) {
-                    convertedArray[convertedSize] = grid[k][m];
-                    convertedSize++;
-                }
-            }
-            if (!checkArray(convertedSize, convertedArray)) {
-                return false;
-            }
+    for (int box = 0; box < size; box++) {
+        for (int i = 0; i < size; i++) {
+            convertedArray[i] = cells[boxes[box * size + i]];
+        }
+        if (!checkArray(size, convertedArray)) {
+            return false;
         }
     }
     return true;
@@ -106,20 +134,15 @@ extern bool validateColsWithSpaces(int size, int grid[size][size])
 
 extern bool validateSquaresWithSpaces(int n, int size, int grid[size][size])
 {
+    uint16_t const *boxes = &layoutFor(n)->units[2 * size * size];
+    int const *cells = &grid[0][0];
     int convertedArray[size];
-    int convertedSize = 0;
-    for (int i = 0; i < size ; i = i + n) {
-        for (int j = 0; j < size; j = j + n) {
-            for (int k = i; k < i + n; k++) {
-                for (int m = j; m < j + n; m++) {
-                    convertedArray[convertedSize] = grid[k][m];
-                    convertedSize++;
-                }
-            }
-            if (!checkArrayWithSpaces(convertedSize, convertedArray)) {
-                return false;
-            }
-            convertedSize = 0;
+    for (int box = 0; box < size; box++) {
+        for (int i = 0; i < size; i++) {
+            convertedArray[i] = cells[boxes[box * size + i]];
+        }
+        if (!checkArrayWithSpaces(size, convertedArray)) {
+            return false;
         }
     }
     return true;
@@ -150,3 +173,30 @@ bool checkArrayWithSpaces(int size, int array[])
     }
     return true;
 }
+
+extern bool validateGrid(int n, int size, int grid[size][size])
+{
+    return validateGrids(n, size, 1, (int const (*)[size][size]) grid, (bool[1]) { false }) == 1;
+}
+
+extern long validateGrids(int n, int size, long count, int const grids[count][size][size],
+                          bool valid[count])
+{
+    int const *cells = &grids[0][0][0];
+    switch (n) {
+    case 2:
+        return validateMany2(cells, count, valid);
+    case 3:
+        return validateMany3(cells, count, valid);
+    case 4:
+        return validateMany4(cells, count, valid);
+    case 5:
+        return validateMany5(cells, count, valid);
+    case 6:
+        return validateMany6(cells, count, valid);
+    case 7:
+        return validateMany7(cells, count, valid);
+    default:
+        return 0;
+    }
+}
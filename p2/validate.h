@@ -5,6 +5,9 @@
  given input is a valid Sudoku grid.
 */
 
+#ifndef VALIDATE_H
+#define VALIDATE_H
+
 #include <stdbool.h>
 
 /**
@@ -56,3 +59,28 @@ bool validateColsWithSpaces(int size, int grid[size][size]);
  @return true if valid, false otherwise
 */
 bool validateSquaresWithSpaces(int n, int size, int grid[size][size]);
+
+/**
+ Validates a grid in a single pass, checking that every value is from 0 to size and that no
+ row, column or subgrid repeats a digit. Empty cells (0) are allowed, so a complete grid is a
+ correct solution exactly when it passes.
+ @param n dimension of subgrid, from MIN_SUBGRID to MAX_SUBGRID
+ @param size size of the row and columns
+ @param grid[size][size] 2D array to evaluate
+ @return true if valid, false otherwise
+*/
+bool validateGrid(int n, int size, int grid[size][size]);
+
+/**
+ Validates many grids of the same size at once, as validateGrid would validate each of them
+ @param n dimension of subgrid, from MIN_SUBGRID to MAX_SUBGRID
+ @param size size of the row and columns
+ @param count number of grids
+ @param grids count grids of size * size values, stored one after another in row-major order
+ @param valid filled in with whether each grid is valid
+ @return number of valid grids
+*/
+long validateGrids(int n, int size, long count, int const grids[count][size][size],
+                   bool valid[count]);
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ @file vkernel.h
+ @author Matthew Kierski (mdkiersk)
+ Validation kernel, written once and compiled separately for every subgrid dimension. Before
+ including this file, define KERNEL_N as the subgrid dimension and KERNEL_MASK as an unsigned
+ integer type with at least KERNEL_N * KERNEL_N bits. Define KERNEL_SIMD as well to check rows
+ of the grid several cells at a time with vector instructions; this needs KERNEL_MASK to be 32
+ bits wide. Including the file defines validateGridN and validateManyN (for example,
+ validateGrid3) and undefines the macros again.
+
+ Every digit becomes a one-hot mask, and the masks are ORed into one mask per row, column and
+ subgrid, so the whole check takes a single pass over the grid.
+
+ There is deliberately no include guard.
+ */
+
+#include "mask.h"
+#include "layout.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/** Pastes a name and a number together, after expanding the number */
+#define KERNEL_PASTE(name, n) KERNEL_PASTE2(name, n)
+/** Pastes a name and a number together */
+#define KERNEL_PASTE2(name, n) name##n
+/** Gives a name specific to this kernel's subgrid dimension */
+#define K(name) KERNEL_PASTE(name, KERNEL_N)
+
+/** Subgrid dimension */
+#define N KERNEL_N
+/** Dimension of entire grid */
+#define SIZE (N * N)
+/** Number of cells in the grid */
+#define CELLS (SIZE * SIZE)
+/** Mask type for this kernel */
+#define KMask KERNEL_MASK
+
+#ifdef KERNEL_SIMD
+
+/** Number of cells checked together by one vector operation, filling an SSE register */
+#define LANES 4
+/** Number of vectors needed to hold a row */
+#define VECS ((SIZE + LANES - 1) / LANES)
+
+/** LANES 32-bit lanes processed together */
+typedef uint32_t K(Vec) __attribute__((vector_size(LANES * sizeof(uint32_t))));
+
+/** LANES signed 32-bit lanes, for converting from floating point */
+typedef int32_t K(IntVec) __attribute__((vector_size(LANES * sizeof(int32_t))));
+
+/** LANES single-precision lanes */
+typedef float K(FloatVec) __attribute__((vector_size(LANES * sizeof(float))));
+
+/** Exponent bias of a single-precision float */
+#define FLOAT_BIAS 127
+/** Position of the exponent in a single-precision float */
+#define FLOAT_EXPONENT 23
+
+/**
+ Checks that a grid has no out-of-range values and no digit repeated within a row, column or
+ subgrid, a row at a time with vector instructions. Instead of counting bits, each unit keeps
+ the sum of its one-hot masks as well as their OR: the two are equal exactly when no bit was
+ added twice. Column sums and ORs are kept per lane, and subgrid ones are gathered from the
+ lanes once every band of N rows.
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty
+ @return true if valid, false otherwise
+ */
+static bool K(validateGrid)(int const *grid)
+{
+    //Lanes past the end of the row stay 0, which has no digit bit
+    K(Vec) row[VECS] = { { 0 } };
+    K(Vec) colSum[VECS] = { { 0 } };
+    K(Vec) colOr[VECS] = { { 0 } };
+    K(Vec) bad = { 0 };
+    uint32_t differ = 0;
+    for (int band = 0; band < SIZE; band += N) {
+        K(Vec) boxSum[VECS] = { { 0 } };
+        K(Vec) boxOr[VECS] = { { 0 } };
+        for (int r = band; r < band + N; r++) {
+            memcpy(row, grid + r * SIZE, sizeof(int) * SIZE);
+            K(Vec) rowSum = { 0 };
+            K(Vec) rowOr = { 0 };
+            for (int v = 0; v < VECS; v++) {
+                K(Vec) value = row[v];
+                bad |= (K(Vec)) (value > SIZE);
+                //Build 2^(value - 1) as a float and convert it, since vector shifts by a
+                //variable amount are slow without AVX2; a value of 0 gives 0.5, which is 0
+                K(Vec) exponent = ((value & 31) + FLOAT_BIAS - 1) << FLOAT_EXPONENT;
+                K(Vec) bit = (K(Vec)) __builtin_convertvector((K(FloatVec)) exponent, K(IntVec));
+                colSum[v] += bit;
+                colOr[v] |= bit;
+                boxSum[v] += bit;
+                boxOr[v] |= bit;
+                rowSum += bit;
+                rowOr |= bit;
+            }
+            uint32_t sum = 0;
+            uint32_t or = 0;
+            for (int lane = 0; lane < LANES; lane++) {
+                sum += rowSum[lane];
+                or |= rowOr[lane];
+            }
+            differ |= sum ^ or;
+        }
+        for (int box = 0; box < SIZE; box += N) {
+            uint32_t sum = 0;
+            uint32_t or = 0;
+            for (int c = box; c < box + N; c++) {
+                sum += boxSum[c / LANES][c % LANES];
+                or |= boxOr[c / LANES][c % LANES];
+            }
+            differ |= sum ^ or;
+        }
+    }
+    for (int v = 0; v < VECS; v++) {
+        bad |= colSum[v] ^ colOr[v];
+    }
+    for (int lane = 0; lane < LANES; lane++) {
+        differ |= bad[lane];
+    }
+    return differ == 0;
+}
+
+#else
+
+/**
+ Checks that a grid has no out-of-range values and no digit repeated within a row, column or
+ subgrid, one cell at a time, looking subgrids up in the layout. A unit has no repeated digit
+ exactly when its mask has as many bits as the unit has filled cells, and since no unit can
+ have more bits than filled cells, it is enough to compare the totals.
+ @param grid SIZE * SIZE cell values in row-major order, 0 for empty
+ @return true if valid, false otherwise
+ */
+static bool K(validateGrid)(int const *grid)
+{
+    uint8_t const *boxOf = layoutFor(N)->box;
+    KMask rows[SIZE] = { 0 };
+    KMask cols[SIZE] = { 0 };
+    KMask boxes[SIZE] = { 0 };
+    int cells = 0;
+    for (int r = 0; r < SIZE; r++) {
+        for (int c = 0; c < SIZE; c++) {
+            unsigned value = grid[r * SIZE + c];
+            if (value > SIZE) {
+                return false;
+            }
+            KMask bit = ((KMask) 1 << value) >> 1;
+            cells += value != 0;
+            rows[r] |= bit;
+            cols[c] |= bit;
+            boxes[boxOf[r * SIZE + c]] |= bit;
+        }
+    }
+    int rowBits = 0;
+    int colBits = 0;
+    int boxBits = 0;
+    for (int i = 0; i < SIZE; i++) {
+        rowBits += countDigits(rows[i]);
+        colBits += countDigits(cols[i]);
+        boxBits += countDigits(boxes[i]);
+    }
+    return rowBits == cells && colBits == cells && boxBits == cells;
+}
+
+#endif
+
+/**
+ Validates many grids of this kernel's dimension, stored one after another
+ @param grids count * CELLS cell values, each grid in row-major order
+ @param count number of grids
+ @param valid filled in with whether each grid is valid
+ @return number of valid grids
+ */
+static long K(validateMany)(int const *grids, long count, bool *valid)
+{
+    long total = 0;
+    for (long i = 0; i < count; i++) {
+        valid[i] = K(validateGrid)(grids + i * CELLS);
+        total += valid[i];
+    }
+    return total;
+}
+
+#undef KERNEL_PASTE
+#undef KERNEL_PASTE2
+#undef K
+#undef N
+#undef SIZE
+#undef CELLS
+#undef KMask
+#undef LANES
+#undef VECS
+#undef FLOAT_BIAS
+#undef FLOAT_EXPONENT
+#undef KERNEL_N
+#undef KERNEL_MASK
+#undef KERNEL_SIMD
@@ -0,0 +1,148 @@
+/**
+Part of the cache component. Words are kept in an open addressing table with linear
+probing, which doubles when half full until it holds CACHE_ENTRIES words. The characters of
+the words are kept together in one growing arena, so the table itself stays small. A full
+cache that has answered fewer than half of its lookups costs more than it saves, since a
+word the list doesn't have is usually turned away quickly by the Bloom filter anyway, so it
+stops being searched.
+@file cache.c
+@author Matthew Kierski
+*/
+
+#include "cache.h"
+#include "wordlist.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Number of slots in a new cache's table */
+#define INITIAL_SLOTS 1024
+
+/** Slot of the table, for one word */
+typedef struct {
+    /** Hash of the word */
+    uint32_t hash;
+    /** Position of the word's characters in the arena */
+    uint32_t offset;
+    /** Number of characters in the word, or 0 if the slot is empty */
+    uint8_t length;
+    /** What lookupWord returned for the word */
+    uint8_t result;
+} Slot;
+
+struct Cache {
+    /** Table of words, with a power of two slots */
+    Slot *table;
+    /** Number of slots in table */
+    int tableSize;
+    /** Number of words in table */
+    int count;
+    /** Characters of every word in the table */
+    char *arena;
+    /** Number of characters used in arena */
+    long arenaLen;
+    /** Number of characters allocated for arena */
+    long arenaCap;
+    /** Number of lookups answered from the table */
+    long hits;
+    /** Number of lookups that went to the word list */
+    long misses;
+    /** True if the cache filled up without paying for itself, so it is no longer searched */
+    bool bypass;
+};
+
+/**
+Stops the program if memory couldn't be allocated
+@param ptr result of the allocation
+@return ptr
+*/
+static void *checked( void *ptr )
+{
+    if (!ptr) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+extern Cache *makeCache( void )
+{
+    Cache *cache = checked(calloc(1, sizeof(Cache)));
+    cache->tableSize = INITIAL_SLOTS;
+    cache->table = checked(calloc(cache->tableSize, sizeof(Slot)));
+    return cache;
+}
+
+extern void freeCache( Cache *cache )
+{
+    free(cache->table);
+    free(cache->arena);
+    free(cache);
+}
+
+/**
+Doubles the number of slots in the table, moving every word to its slot in the new table
+@param cache cache to grow
+*/
+static void growTable( Cache *cache )
+{
+    int size = cache->tableSize * 2;
+    Slot *table = checked(calloc(size, sizeof(Slot)));
+    for (int i = 0; i < cache->tableSize; i++) {
+        if (cache->table[i].length) {
+            int j = cache->table[i].hash & (size - 1);
+            while (table[j].length) {
+                j = (j + 1) & (size - 1);
+            }
+            table[j] = cache->table[i];
+        }
+    }
+    free(cache->table);
+    cache->table = table;
+    cache->tableSize = size;
+}
+
+extern int cachedLookup( Cache *cache, char const word[], int len )
+{
+    if (len > CACHE_WORD_LEN || cache->bypass) {
+        cache->misses++;
+        return lookupWord(word, len);
+    }
+    uint32_t hash = hashWord(word, len);
+    int i = hash & (cache->tableSize - 1);
+    for (; cache->table[i].length; i = (i + 1) & (cache->tableSize - 1)) {
+        Slot const *slot = &cache->table[i];
+        if (slot->hash == hash && slot->length == len &&
+            memcmp(cache->arena + slot->offset, word, len) == 0) {
+            cache->hits++;
+            return slot->result;
+        }
+    }
+
+    cache->misses++;
+    int result = lookupWord(word, len);
+    if (cache->count == CACHE_ENTRIES) {
+        cache->bypass = cache->hits < cache->misses;
+    }
+    else {
+        if (cache->arenaLen + len > cache->arenaCap) {
+            cache->arenaCap = cache->arenaCap ? cache->arenaCap * 2 : INITIAL_SLOTS * 8;
+            cache->arena = checked(realloc(cache->arena, cache->arenaCap));
+        }
+        memcpy(cache->arena + cache->arenaLen, word, len);
+        cache->table[i] = (Slot) { hash, cache->arenaLen, len, result };
+        cache->arenaLen += len;
+        if (++cache->count * 2 > cache->tableSize) {
+            growTable(cache);
+        }
+    }
+    return result;
+}
+
+extern void cacheCounts( Cache const *cache, long *hits, long *misses )
+{
+    *hits = cache->hits;
+    *misses = cache->misses;
+}
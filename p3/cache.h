@@ -0,0 +1,45 @@
+/**
+Serves as the header file of the cache component. Provides a cache of the results of
+lookupWord, so a word repeated through a document is looked up on the word list only once.
+@file cache.h
+@author Matthew Kierski
+*/
+
+/** Most different words kept in one cache; later new words are looked up every time, and
+ if the cache has answered fewer than half its lookups by then, so is every word */
+#define CACHE_ENTRIES 65536
+/** Longest word kept in the cache */
+#define CACHE_WORD_LEN 64
+
+/** Cache of lookupWord results, only used by one thread at a time */
+typedef struct Cache Cache;
+
+/**
+Makes an empty cache
+@return new cache, to be freed with freeCache
+*/
+Cache *makeCache( void );
+
+/**
+Frees a cache and every word in it
+@param cache cache to free
+*/
+void freeCache( Cache *cache );
+
+/**
+Looks up a word, from the cache if it has been looked up before and otherwise with
+lookupWord, remembering the result
+@param cache cache to use
+@param word word to look up
+@param len number of characters in word
+@return the same as lookupWord
+*/
+int cachedLookup( Cache *cache, char const word[], int len );
+
+/**
+Gives the number of lookups a cache has answered, with and without the word list
+@param cache cache to report on
+@param hits filled in with the number of lookups answered from the cache
+@param misses filled in with the number of lookups that went to the word list
+*/
+void cacheCounts( Cache const *cache, long *hits, long *misses );
@@ -0,0 +1,135 @@
+/**
+Part of the classify component. Sorts characters into word characters and separators with
+vector instructions where the compiler offers them: 32 characters per instruction with AVX2
+and 16 with SSE2, which every x86-64 processor has. Building with -DSCALAR_CLASSIFY, or for
+a processor without either, uses a plain loop over wordChar instead. Runs are found in the
+masks 64 characters at a time by counting zero bits.
+@file classify.c
+@author Matthew Kierski
+*/
+
+#include "classify.h"
+#include "wordlist.h"
+
+#if !defined(SCALAR_CLASSIFY) && (defined(__AVX2__) || defined(__SSE2__))
+#include <immintrin.h>
+#define VECTOR_CLASSIFY
+#endif
+
+extern long maskLength( long len )
+{
+    return (len + MASK_BITS - 1) / MASK_BITS;
+}
+
+/**
+Classifies up to MASK_BITS characters one at a time
+@param text characters to classify
+@param len number of characters, at most MASK_BITS
+@param words filled in with the mask of word characters
+@param stops filled in with the mask of word characters and newlines
+*/
+static void classifyScalar( char const text[], int len, uint64_t *words, uint64_t *stops )
+{
+    uint64_t w = 0;
+    uint64_t s = 0;
+    for (int i = 0; i < len; i++) {
+        if (wordChar(text[i])) {
+            w |= (uint64_t) 1 << i;
+        }
+        else if (text[i] == '\n') {
+            s |= (uint64_t) 1 << i;
+        }
+    }
+    *words = w;
+    *stops = w | s;
+}
+
+#ifdef VECTOR_CLASSIFY
+#ifdef __AVX2__
+/** Number of characters classified by each vector instruction */
+#define VECTOR_WIDTH 32
+
+/**
+Classifies 32 characters at once. A letter of either case becomes a lowercase letter when
+bit 5 is set, and no other character does, so one range test finds all letters. The range
+test adds a bias that moves 'a' to the smallest signed value, since the vector compares are
+signed.
+@param text characters to classify
+@param newlines filled in with a mask of the newlines
+@return mask of the word characters
+*/
+static uint64_t classifyVector( char const text[], uint64_t *newlines )
+{
+    __m256i ch = _mm256_loadu_si256((__m256i const *) text);
+    __m256i biased = _mm256_add_epi8(_mm256_or_si256(ch, _mm256_set1_epi8(0x20)),
+                                      _mm256_set1_epi8((char) (0x80 - 'a')));
+    __m256i letter = _mm256_cmpgt_epi8(_mm256_set1_epi8((char) (0x80 + 26)), biased);
+    __m256i apostrophe = _mm256_cmpeq_epi8(ch, _mm256_set1_epi8('\''));
+    *newlines = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(ch, _mm256_set1_epi8('\n')));
+    return (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(letter, apostrophe));
+}
+#else
+/** Number of characters classified by each vector instruction */
+#define VECTOR_WIDTH 16
+
+/**
+Classifies 16 characters at once. A letter of either case becomes a lowercase letter when
+bit 5 is set, and no other character does, so one range test finds all letters. The range
+test adds a bias that moves 'a' to the smallest signed value, since the vector compares are
+signed.
+@param text characters to classify
+@param newlines filled in with a mask of the newlines
+@return mask of the word characters
+*/
+static uint64_t classifyVector( char const text[], uint64_t *newlines )
+{
+    __m128i ch = _mm_loadu_si128((__m128i const *) text);
+    __m128i biased = _mm_add_epi8(_mm_or_si128(ch, _mm_set1_epi8(0x20)),
+                                  _mm_set1_epi8((char) (0x80 - 'a')));
+    __m128i letter = _mm_cmplt_epi8(biased, _mm_set1_epi8((char) (0x80 + 26)));
+    __m128i apostrophe = _mm_cmpeq_epi8(ch, _mm_set1_epi8('\''));
+    *newlines = (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(ch, _mm_set1_epi8('\n')));
+    return (uint16_t) _mm_movemask_epi8(_mm_or_si128(letter, apostrophe));
+}
+#endif
+#endif
+
+extern void classifyText( char const text[], long len, uint64_t words[], uint64_t stops[] )
+{
+    long group = 0;
+#ifdef VECTOR_CLASSIFY
+    for (; (group + 1) * MASK_BITS <= len; group++) {
+        uint64_t w = 0;
+        uint64_t s = 0;
+        for (int i = 0; i < MASK_BITS; i += VECTOR_WIDTH) {
+            uint64_t newlines;
+            w |= classifyVector(text + group * MASK_BITS + i, &newlines) << i;
+            s |= newlines << i;
+        }
+        words[group] = w;
+        stops[group] = w | s;
+    }
+#endif
+    //Whatever is left, including the short group at the end, is done one at a time
+    for (; group * MASK_BITS < len; group++) {
+        long rest = len - group * MASK_BITS;
+        classifyScalar(text + group * MASK_BITS, rest < MASK_BITS ? rest : MASK_BITS,
+                       &words[group], &stops[group]);
+    }
+}
+
+extern long findBit( uint64_t const mask[], long from, long to, bool value )
+{
+    long pos = from;
+    while (pos < to) {
+        //Bits of this element from pos on, flipped if looking for a clear bit
+        uint64_t bits = (value ? mask[pos / MASK_BITS] : ~mask[pos / MASK_BITS])
+                        >> (pos % MASK_BITS);
+        if (bits) {
+            long found = pos + __builtin_ctzll(bits);
+            return found < to ? found : to;
+        }
+        pos += MASK_BITS - pos % MASK_BITS;
+    }
+    return to;
+}
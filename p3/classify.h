@@ -0,0 +1,41 @@
+/**
+Serves as the header file of the classify component. Provides methods that sort the
+characters of a block of text into word characters and separators many at a time, as bit
+masks, and find where each run of word characters or separators ends.
+@file classify.h
+@author Matthew Kierski
+*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Number of characters described by each element of a mask */
+#define MASK_BITS 64
+
+/**
+Returns the number of mask elements needed to describe a block of text
+@param len number of characters in the block
+@return number of elements each mask needs
+*/
+long maskLength( long len );
+
+/**
+Classifies every character of a block of text. Bit i of a mask describes character i of the
+block, counting from the low bit of the first element. Bits past the end of the block are
+left clear.
+@param text block of text to classify
+@param len number of characters in text
+@param words filled in with a mask of the characters for which wordChar is true
+@param stops filled in with a mask of the characters that end a run of separators, which are
+the word characters and newlines
+*/
+void classifyText( char const text[], long len, uint64_t words[], uint64_t stops[] );
+
+/**
+Finds the first bit of a mask with a given value, from one position up to another
+@param mask mask to search
+@param from first position to look at
+@param to position just past the last one to look at
+@param value value of the bit to find
+@return position of the first bit with the value, or to if there isn't one
+*/
+long findBit( uint64_t const mask[], long from, long to, bool value );
@@ -1,18 +1,29 @@
 /**
 Serves as the implementation of the document header file. Provides methods
 responsible for readingthe document, using wordlist to check the spelling of
-individual words, and printing outthe document in proper format
+individual words, and printing outthe document in proper format. The document is read
+and the output written in large blocks, so a long document costs a few system calls
+rather than a library call per character. Lines can be any length: each block is split
+into words and separators as it comes, using masks of the whole block built by classify,
+and only a word that runs past the end of a block is copied, so it can be finished with the
+next block. Given more than one thread, large pieces of the document are cut at line
+boundaries and checked at the same time, each into its own output, and the outputs are
+written in order. Each stream keeps a cache of the words it has looked up, so a word
+repeated through the document is looked up on the word list once.
 @file document.c
 @author Matthew Kierski
 */
 
 #include "document.h"
 #include "wordlist.h"
+#include "suggest.h"
+#include "pool.h"
+#include "classify.h"
+#include "cache.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
-#include <ctype.h>
 
 /** Escape sequence for red character */
 #define RED "\033[31m"
@@ -20,79 +31,520 @@ individual words, and printing outthe document in proper format
 #define BLUE "\033[34m"
 /** Escape sequence for default character */
 #define RESET "\033[0m"
-/** Return value for lookupWord when word is pronoun */
-#define PRONOUN 2
-/** Return value for lookupWord when word is non pronoun */
-#define NON_PRONOUN 1
-/** Return value for lookupWord when word is not found */
-#define WORD_NOT_FOUND 0
-/** Max length of word (including null terminator) */
-#define WORD_LEN 13
-/** Max length of line (including null terminator) */
-#define LINE_LEN 76
-
-static void checkLine( char const line[], bool ellipsis, bool chopped )
+/** Most characters of a word kept while it is split across blocks (including one spare) */
+#define TOKEN_LEN (MAX_LINE_LIMIT + 1)
+/** Most unknown words on a line that suggestions are printed for, so a line of any length
+ keeps a bounded number of them */
+#define MAX_UNKNOWN 64
+/** Number of characters read from the document at a time */
+#define READ_SIZE 65536
+/** Number of characters of output collected before it is written */
+#define WRITE_SIZE 65536
+/** Number of characters of the document in each piece checked by one thread */
+#define CHUNK_SIZE 262144
+/** Number of pieces checked in each round, for each thread, so busy threads even out */
+#define CHUNKS_PER_THREAD 4
+
+/** State of the document being checked, carried from one block to the next */
+typedef struct {
+    /** How to check and print the document */
+    DocumentOptions const *options;
+    /** Characters of a word that ran past the end of the last block */
+    char token[TOKEN_LEN];
+    /** Number of characters in token */
+    int tokenLen;
+    /** True if the word in token grew too long to keep, so its start was printed already */
+    bool tokenLong;
+    /** Number of characters of the current line seen so far */
+    long column;
+    /** True if the current line went past the line limit, so the rest of it is skipped */
+    bool chopped;
+    /** Unknown words on the current line waiting for suggestions, each after its length */
+    char *unknown;
+    /** Number of characters used in unknown */
+    int unknownLen;
+    /** Number of characters allocated for unknown */
+    int unknownCap;
+    /** Number of unknown words on the current line, including any past MAX_UNKNOWN that
+     weren't kept */
+    int unknownCount;
+    /** Mask of the word characters in the block being checked */
+    uint64_t *words;
+    /** Mask of the characters in the block being checked that end a run of separators */
+    uint64_t *stops;
+    /** Number of elements allocated for each of words and stops */
+    long maskCap;
+    /** Words looked up so far, kept from one block or round to the next */
+    Cache *cache;
+    /** Output not yet written */
+    char *out;
+    /** Number of characters in out */
+    long outLen;
+    /** Number of characters allocated for out */
+    long outCap;
+    /** File the output is written to once WRITE_SIZE characters collect, or NULL to keep all
+     of it in out */
+    FILE *sink;
+} Stream;
+
+/**
+Changes the size of a dynamically allocated array, exiting if memory runs out
+@param array array to resize, or NULL to allocate a new one
+@param size new size of the array, in bytes
+@return resized array
+*/
+static void *resize( void *array, size_t size )
 {
-    char ch = line[0];
-    char word[WORD_LEN];
-    word[0] = ch;
-    int count = 1;
-    int i = 1;
-    while (ch != '\0') {
-        ch = line[count++];
-        if (ch != ' ' && ch != '\n' && ispunct(ch) == 0) {
-            word[i++] = ch;
-        }
-        if (ch == '\0' || ch == '\n' || ch == ' ' || ispunct(ch) != 0) {
-            if (lookupWord(word) == WORD_NOT_FOUND) {
-                //Print in red
-                printf(RED "%s" RESET, word);
-            }
-            else if (lookupWord(word) == NON_PRONOUN) {
-                //Print in default
-                printf("%s", word);
+    array = realloc(array, size);
+    if (!array) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    return array;
+}
+
+/**
+Writes out all output collected so far
+@param st state of the document
+*/
+static void flushOutput( Stream *st )
+{
+    fwrite(st->out, 1, st->outLen, st->sink);
+    st->outLen = 0;
+}
+
+/**
+Adds characters to the output, writing the output out when it fills up
+@param st state of the document
+@param text characters to add
+@param len number of characters in text
+*/
+static void put( Stream *st, char const text[], long len )
+{
+    if (st->sink && st->outLen + len > WRITE_SIZE) {
+        flushOutput(st);
+        if (len > WRITE_SIZE) {
+            fwrite(text, 1, len, st->sink);
+            return;
+        }
+    }
+    if (st->outLen + len > st->outCap) {
+        st->outCap = st->outCap * 2 > st->outLen + len ? st->outCap * 2 : st->outLen + len;
+        st->out = resize(st->out, st->outCap);
+    }
+    memcpy(st->out + st->outLen, text, len);
+    st->outLen += len;
+}
+
+/**
+Adds a null terminated string to the output
+@param st state of the document
+@param text string to add
+*/
+static void putString( Stream *st, char const text[] )
+{
+    put(st, text, strlen(text));
+}
+
+/**
+Remembers an unknown word, so suggestions for it can be printed at the end of its line. Only
+the first MAX_UNKNOWN on a line are kept; the rest are just counted.
+@param st state of the document
+@param word unknown word
+@param len number of characters in word
+*/
+static void addUnknown( Stream *st, char const word[], int len )
+{
+    if (st->unknownCount++ >= MAX_UNKNOWN) {
+        return;
+    }
+    if (st->unknownLen + (int) sizeof(int) + len > st->unknownCap) {
+        st->unknownCap = st->unknownCap ? st->unknownCap * 2 : 1024;
+        st->unknownCap += len;
+        st->unknown = resize(st->unknown, st->unknownCap);
+    }
+    memcpy(st->unknown + st->unknownLen, &len, sizeof(int));
+    memcpy(st->unknown + st->unknownLen + sizeof(int), word, len);
+    st->unknownLen += sizeof(int) + len;
+}
+
+/**
+Prints a whole word, coloring it red if it isn't on the word list and blue if it is a proper
+noun
+@param st state of the document
+@param word word to print
+@param len number of characters in word
+@param check false if the word was cut off at the line limit, so it is printed without
+checking it
+*/
+static void putWord( Stream *st, char const word[], long len, bool check )
+{
+    //A word too long to carry between blocks is unknown wherever it falls, so output doesn't
+    //depend on how the document was split into blocks
+    int result = !check ? NON_PRONOUN :
+                 len >= TOKEN_LEN ? WORD_NOT_FOUND : cachedLookup(st->cache, word, len);
+    if (result == WORD_NOT_FOUND) {
+        //Print in red
+        putString(st, RED);
+        put(st, word, len);
+        putString(st, RESET);
+        if (st->options->suggestions > 0 && len < TOKEN_LEN) {
+            addUnknown(st, word, len);
+        }
+    }
+    else if (result == PRONOUN) {
+        //Print in blue
+        putString(st, BLUE);
+        put(st, word, len);
+        putString(st, RESET);
+    }
+    else {
+        //Print in default
+        put(st, word, len);
+    }
+}
+
+/**
+Adds the start of a word that runs past the end of a block to the word being carried over. A
+word too long to keep can't be on the list, so it is printed in red as it comes.
+@param st state of the document
+@param chars characters of the word in this block
+@param len number of characters
+*/
+static void carryWord( Stream *st, char const chars[], long len )
+{
+    if (!st->tokenLong && st->tokenLen + len < TOKEN_LEN) {
+        memcpy(st->token + st->tokenLen, chars, len);
+        st->tokenLen += len;
+        return;
+    }
+    if (!st->tokenLong) {
+        putString(st, RED);
+        put(st, st->token, st->tokenLen);
+        st->tokenLong = true;
+    }
+    put(st, chars, len);
+}
+
+/**
+Finishes the word carried over from earlier blocks, if there is one
+@param st state of the document
+@param check false if the word was cut off at the line limit
+*/
+static void endWord( Stream *st, bool check )
+{
+    if (st->tokenLong) {
+        putString(st, RESET);
+    }
+    else if (st->tokenLen > 0) {
+        putWord(st, st->token, st->tokenLen, check);
+    }
+    st->tokenLen = 0;
+    st->tokenLong = false;
+}
+
+/**
+Finishes a line, printing the suggestions for its unknown words after it
+@param st state of the document
+*/
+static void endLine( Stream *st )
+{
+    endWord(st, true);
+    putString(st, st->chopped ? "...\n" : "\n");
+    int suggestions = st->options->suggestions;
+    for (int pos = 0; pos < st->unknownLen; ) {
+        int len;
+        memcpy(&len, st->unknown + pos, sizeof(int));
+        char const *word = st->unknown + pos + sizeof(int);
+        pos += sizeof(int) + len;
+        char const *found[suggestions];
+        int foundLen[suggestions];
+        int count = suggestWords(word, len, suggestions, found, foundLen);
+        putString(st, "  ");
+        put(st, word, len);
+        putString(st, ":");
+        for (int k = 0; k < count; k++) {
+            putString(st, k > 0 ? ", " : " ");
+            put(st, found[k], foundLen[k]);
+        }
+        putString(st, count > 0 ? "\n" : " no suggestions\n");
+    }
+    if (st->unknownCount > MAX_UNKNOWN) {
+        char more[64];
+        snprintf(more, sizeof(more), "  %d more unknown words\n", st->unknownCount - MAX_UNKNOWN);
+        putString(st, more);
+    }
+    st->unknownLen = 0;
+    st->unknownCount = 0;
+    st->column = 0;
+    st->chopped = false;
+}
+
+/**
+Checks and prints one block of the document
+@param st state of the document, carried from the block before
+@param block characters of the block
+@param len number of characters in block
+*/
+static void checkBlock( Stream *st, char const block[], long len )
+{
+    int limit = st->options->lineLimit;
+    if (maskLength(len) > st->maskCap) {
+        st->maskCap = maskLength(len);
+        st->words = resize(st->words, st->maskCap * sizeof(uint64_t));
+        st->stops = resize(st->stops, st->maskCap * sizeof(uint64_t));
+    }
+    classifyText(block, len, st->words, st->stops);
+
+    char const *next = block;
+    char const *end = block + len;
+    while (next < end) {
+        if (st->chopped) {
+            next = memchr(next, '\n', end - next);
+            if (!next) {
+                return;
             }
-            else if (lookupWord(word) == PRONOUN) {
-                //Print in blue
-                printf(BLUE "%s" RESET, word);
+        }
+        if (*next == '\n') {
+            endLine(st);
+            next++;
+            continue;
+        }
+        if (limit > 0 && st->column == limit) {
+            //Part of a word at the end of a chopped line can't be checked
+            endWord(st, false);
+            st->chopped = true;
+            continue;
+        }
+
+        //Take a run of word characters or of separators, stopping at the line limit
+        char const *stop = limit > 0 && end - next > limit - st->column ?
+                           next + (limit - st->column) : end;
+        char const *run = next;
+        long pos = next - block;
+        bool word = st->words[pos / MASK_BITS] >> (pos % MASK_BITS) & 1;
+        next = block + findBit(word ? st->words : st->stops, pos, stop - block, !word);
+        st->column += next - run;
+        if (!word) {
+            endWord(st, true);
+            put(st, run, next - run);
+        }
+        else if (next == stop) {
+            //The word may go on past the block or the line limit
+            carryWord(st, run, next - run);
+        }
+        else if (st->tokenLen > 0 || st->tokenLong) {
+            carryWord(st, run, next - run);
+            endWord(st, true);
+        }
+        else {
+            putWord(st, run, next - run, true);
+        }
+    }
+}
+
+/**
+Prints how well the word caches did to standard error
+@param hits number of lookups answered from a cache
+@param misses number of lookups that went to the word list
+*/
+static void printStats( long hits, long misses )
+{
+    long lookups = hits + misses;
+    fprintf(stderr, "Word cache: %ld lookups, %ld hits, %ld misses, %.1f%% hit rate\n", lookups,
+            hits, misses, lookups ? 100.0 * hits / lookups : 0.0);
+}
+
+/** A round of pieces of the document checked at the same time */
+typedef struct {
+    /** State of each piece, reused from round to round */
+    Stream *streams;
+    /** Start of each piece, with one more entry giving the end of the last */
+    char const **starts;
+    /** True if the last piece ends the document */
+    bool last;
+} Round;
+
+/**
+Checks one piece of the document, keeping all of its output
+@param context round the piece belongs to
+@param index number of the piece in the round
+*/
+static void checkChunk( void *context, int index )
+{
+    Round *round = context;
+    Stream *st = &round->streams[index];
+    checkBlock(st, round->starts[index], round->starts[index + 1] - round->starts[index]);
+    if (round->last && (st->column > 0 || st->chopped)) {
+        endLine(st);
+    }
+}
+
+/**
+Checks a line too long to fit in the buffer on its own, streaming it through the buffer a
+block at a time the way a sequential check does, so it takes no more memory than any other
+line. Output for the document before the line must already be written.
+@param fp document being checked
+@param st state for the line, writing its output straight to standard output
+@param buffer buffer holding the start of the line, with no newline in it
+@param len number of characters in buffer
+@param cap number of characters buffer can hold
+@return number of characters after the end of the line, moved to the start of buffer
+*/
+static long checkLongLine( FILE *fp, Stream *st, char *buffer, long len, long cap )
+{
+    checkBlock(st, buffer, len);
+    while (true) {
+        len = fread(buffer, 1, cap, fp);
+        char const *newline = memchr(buffer, '\n', len);
+        if (newline) {
+            long end = newline + 1 - buffer;
+            checkBlock(st, buffer, end);
+            flushOutput(st);
+            memmove(buffer, buffer + end, len - end);
+            return len - end;
+        }
+        checkBlock(st, buffer, len);
+        if (len < cap) {
+            //The line ends the document
+            if (st->column > 0 || st->chopped) {
+                endLine(st);
             }
-            memset(word, 0, WORD_LEN);
-            i = 0;
-            if (ch != '\0') {
-                printf("%c", ch);
-            } else {
-                printf("%c", '\n');
+            flushOutput(st);
+            return 0;
+        }
+    }
+}
+
+/**
+Checks a document on several threads. Each round reads as many whole lines as fit in a
+buffer, cuts them into pieces at line boundaries, checks the pieces at the same time and
+writes their outputs in order. Every piece starts at the start of a line, so it can be
+checked without knowing anything about the pieces before it. A line too long for the buffer
+is checked on its own by checkLongLine, so memory use is the same for any document.
+@param fp document to check
+@param options how to check and print the document
+*/
+static void checkParallel( FILE *fp, DocumentOptions const *options )
+{
+    int chunks = options->threads * CHUNKS_PER_THREAD;
+    long cap = (long) chunks * CHUNK_SIZE;
+    char *buffer = malloc(cap);
+    //The stream after the last piece's is for lines too long for the buffer
+    Round round = { calloc(chunks + 1, sizeof(Stream)), malloc((chunks + 1) * sizeof(char *)),
+                    false };
+    if (!buffer || !round.streams || !round.starts) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    long len = 0;
+    while (!round.last) {
+        len += fread(buffer + len, 1, cap - len, fp);
+        round.last = len < cap;
+        long cut = len;
+        while (!round.last && cut > 0 && buffer[cut - 1] != '\n') {
+            cut--;
+        }
+        if (cut == 0 && !round.last) {
+            Stream *line = &round.streams[chunks];
+            if (!line->cache) {
+                *line = (Stream) { .options = options, .sink = stdout, .cache = makeCache() };
             }
+            len = checkLongLine(fp, line, buffer, len, cap);
+            continue;
+        }
+
+        //Split at the first newline after each even share of the lines read
+        int count = 0;
+        char const *start = buffer;
+        char const *end = buffer + cut;
+        while (start < end) {
+            round.starts[count++] = start;
+            char const *stop = start + (cut + chunks - 1) / chunks;
+            stop = stop < end ? memchr(stop - 1, '\n', end - (stop - 1)) : NULL;
+            start = stop ? stop + 1 : end;
+        }
+        round.starts[count] = end;
+        for (int i = 0; i < count; i++) {
+            Stream *st = &round.streams[i];
+            *st = (Stream) { .options = options, .unknown = st->unknown,
+                             .unknownCap = st->unknownCap, .out = st->out,
+                             .outCap = st->outCap, .words = st->words,
+                             .stops = st->stops, .maskCap = st->maskCap,
+                             .cache = st->cache ? st->cache : makeCache() };
         }
+        runPool(options->threads, count, checkChunk, &round);
+        for (int i = 0; i < count; i++) {
+            fwrite(round.streams[i].out, 1, round.streams[i].outLen, stdout);
+        }
+        memmove(buffer, buffer + cut, len - cut);
+        len -= cut;
+    }
+    long hits = 0;
+    long misses = 0;
+    for (int i = 0; i <= chunks; i++) {
+        if (round.streams[i].cache) {
+            long streamHits, streamMisses;
+            cacheCounts(round.streams[i].cache, &streamHits, &streamMisses);
+            hits += streamHits;
+            misses += streamMisses;
+            freeCache(round.streams[i].cache);
+        }
+        free(round.streams[i].unknown);
+        free(round.streams[i].out);
+        free(round.streams[i].words);
+        free(round.streams[i].stops);
+    }
+    if (options->stats) {
+        printStats(hits, misses);
     }
+    free(round.streams);
+    free(round.starts);
+    free(buffer);
 }
 
-extern void checkDocument( char const fileName[] )
+extern void checkDocument( char const fileName[], DocumentOptions const *options )
 {
     FILE *fp = fopen(fileName, "r");
     if (!fp) {
         fprintf(stderr, "Can't open file: %s\n", fileName);
         exit(EXIT_FAILURE);
     }
-    
-    int count = 0;
-    char line[LINE_LEN];
-    char ch = fgetc(fp);
-    while (ch != EOF) {
-        line[count] = ch;
-        count++;
-        ch = fgetc(fp);
-        if (ch == '\n') {
-            line[count] = '\0';
-            checkLine(line, false, false);
-            memset(line, 0, LINE_LEN);
-            count = 0;
-        }
-        if (count == LINE_LEN - 1) {
-            line[count] = '\0';
-            checkLine(line, true, true);
-            memset(line, 0, LINE_LEN);
-            count = 0;
-        }
+    if (options->threads > 1) {
+        checkParallel(fp, options);
+        fclose(fp);
+        return;
+    }
+
+    Stream *st = calloc(1, sizeof(Stream));
+    char *block = malloc(READ_SIZE);
+    if (!st || !block) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    st->options = options;
+    st->sink = stdout;
+    st->cache = makeCache();
+    size_t blockLen;
+    while ((blockLen = fread(block, 1, READ_SIZE, fp)) > 0) {
+        checkBlock(st, block, blockLen);
+    }
+    //A last line with no newline is finished as if it had one
+    if (st->column > 0 || st->chopped) {
+        endLine(st);
+    }
+    flushOutput(st);
+    free(st->out);
+    free(st->unknown);
+    if (options->stats) {
+        long hits, misses;
+        cacheCounts(st->cache, &hits, &misses);
+        printStats(hits, misses);
     }
+    freeCache(st->cache);
+    free(st->words);
+    free(st->stops);
+    free(st);
+    free(block);
+    fclose(fp);
 }
@@ -0,0 +1,34 @@
+/**
+Serves as the header file of the document component. Provides methods responsible for
+reading the document, using wordlist to check the spelling of individual words, and
+printing out the document in proper format.
+@file document.h
+@author Matthew Kierski
+*/
+#include <stdbool.h>
+
+/** Longest line limit allowed; words up to this long are always checked whole */
+#define MAX_LINE_LIMIT 4095
+
+/** Options for checking a document */
+typedef struct {
+    /** Most suggestions to print after each line for each unknown word on it, or 0 to print
+     none; buildSuggestions must have been called if it isn't 0 */
+    int suggestions;
+    /** Number of characters of each line to show, from 1 to MAX_LINE_LIMIT, the rest being
+     replaced by "...", or 0 to show every line whole */
+    int lineLimit;
+    /** Number of threads to check the document with; with more than one, pieces of the
+     document are checked at the same time, and the output is the same */
+    int threads;
+    /** True to print how many word lookups the word caches answered to standard error */
+    bool stats;
+} DocumentOptions;
+
+/**
+Reads the given document, checking the spelling of each word against the word list and
+printing the document with unknown words in red and proper nouns in blue.
+@param fileName name of document to check
+@param options how to check and print the document
+*/
+void checkDocument( char const fileName[], DocumentOptions const *options );
@@ -0,0 +1,66 @@
+/**
+Part of the pool component. Runs independent jobs on worker threads. Each worker
+repeatedly claims the next unclaimed index with an atomic increment, so no locks are
+needed while jobs are running.
+@file pool.c
+@author Matthew Kierski
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "pool.h"
+#include <pthread.h>
+#include <unistd.h>
+
+/** Work shared by every thread in one call to runPool */
+typedef struct {
+    /** Next job index that hasn't been claimed */
+    int next;
+    /** Number of jobs to run */
+    int jobs;
+    /** Function to run for each index */
+    void (*job)( void *context, int index );
+    /** Pointer passed to every call of job */
+    void *context;
+} Work;
+
+/**
+Body of a worker thread, claiming and running jobs until none are left
+@param arg the shared Work record
+@return NULL
+*/
+static void *worker( void *arg )
+{
+    Work *work = arg;
+    int index;
+    while ((index = __atomic_fetch_add(&work->next, 1, __ATOMIC_RELAXED)) < work->jobs) {
+        work->job(work->context, index);
+    }
+    return NULL;
+}
+
+extern void runPool( int threads, int jobs, void (*job)( void *context, int index ), void *context )
+{
+    Work work = { 0, jobs, job, context };
+    if (threads > jobs) {
+        threads = jobs;
+    }
+    //The calling thread works too, so only threads - 1 new threads are needed
+    pthread_t ids[threads > 1 ? threads - 1 : 1];
+    int started = 0;
+    for (int i = 0; i < threads - 1; i++) {
+        if (pthread_create(&ids[started], NULL, worker, &work) == 0) {
+            started++;
+        }
+    }
+    worker(&work);
+    for (int i = 0; i < started; i++) {
+        pthread_join(ids[i], NULL);
+    }
+}
+
+extern int defaultThreads( void )
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count < 1 ? 1 : count;
+}
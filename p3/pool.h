@@ -0,0 +1,22 @@
+/**
+Serves as the header file of the pool component. Provides methods that run many
+independent jobs on a fixed set of worker threads.
+@file pool.h
+@author Matthew Kierski
+*/
+
+/**
+Runs a job for every index from 0 to jobs - 1 on a pool of worker threads, returning once
+all of them have finished. Workers claim indices in increasing order, one at a time.
+@param threads number of worker threads to use
+@param jobs number of jobs to run
+@param job function to run for each index, given the shared context
+@param context pointer passed to every call of job
+*/
+void runPool( int threads, int jobs, void (*job)( void *context, int index ), void *context );
+
+/**
+Returns the number of processors available, for use as a default thread count
+@return number of online processors, or 1 if it can't be determined
+*/
+int defaultThreads( void );
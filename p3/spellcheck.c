@@ -5,29 +5,102 @@ to load the word lists and spellcheck the document
 @author Matthew Kierski
 */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "document.h"
 #include "wordlist.h"
+#include "suggest.h"
+#include "pool.h"
 
 
+/** Number of suggestions given for each unknown word by --suggest with no number */
+#define DEFAULT_SUGGESTIONS 3
+
 /**
 This is the starting point of our program. It will read in words from the word list and
 store them in memory. It will then read in words from a given document and compare them
-against the word list. Finally, it will print out the edited version of the document file
+against the word list. Finally, it will print out the edited version of the document file.
+Run as "spellcheck --compile dict.bin word-lists..." it instead compiles the word lists into
+a dictionary that can be given in place of them. Options may come first: "--fp-rate=RATE"
+sets the false positive rate of the word list's Bloom filter, "--suggest[=K]" prints up
+to K suggestions for each unknown word after the line it is on, "--line-limit=N" shows
+only the first N characters of each line, and "--threads[=N]" checks the document on N
+threads (one for each processor if N is left out). "--stats" reports how many word lookups
+were answered from the word cache.
 @return exit success
 */
 int main ( int argc, char *argv[] )
 {
-    if (argc < 2) {
+    int first = 1;
+    DocumentOptions options = { 0, 0, 1, false };
+    while (first < argc && strncmp(argv[first], "--", 2) == 0 &&
+           strcmp(argv[first], "--compile") != 0) {
+        char *end = "";
+        if (strncmp(argv[first], "--fp-rate=", 10) == 0) {
+            double rate = strtod(argv[first] + 10, &end);
+            if (!(rate > 0 && rate < 1)) {
+                end = "invalid";
+            }
+            setFalsePositiveRate(rate);
+        }
+        else if (strcmp(argv[first], "--suggest") == 0) {
+            options.suggestions = DEFAULT_SUGGESTIONS;
+        }
+        else if (strncmp(argv[first], "--suggest=", 10) == 0) {
+            options.suggestions = strtol(argv[first] + 10, &end, 10);
+            if (options.suggestions < 1) {
+                end = "invalid";
+            }
+        }
+        else if (strncmp(argv[first], "--line-limit=", 13) == 0) {
+            options.lineLimit = strtol(argv[first] + 13, &end, 10);
+            if (options.lineLimit < 1 || options.lineLimit > MAX_LINE_LIMIT) {
+                end = "invalid";
+            }
+        }
+        else if (strcmp(argv[first], "--threads") == 0) {
+            options.threads = defaultThreads();
+        }
+        else if (strncmp(argv[first], "--threads=", 10) == 0) {
+            options.threads = strtol(argv[first] + 10, &end, 10);
+            if (options.threads < 1) {
+                end = "invalid";
+            }
+        }
+        else if (strcmp(argv[first], "--stats") == 0) {
+            options.stats = true;
+        }
+        else {
+            end = "invalid";
+        }
+        if (*end != '\0') {
+            fprintf(stderr, "Invalid option: %s\n", argv[first]);
+            return EXIT_FAILURE;
+        }
+        first++;
+    }
+
+    if (argc - first < 1) {
         return EXIT_FAILURE;
     }
-    else if (argc == 2) {
-        checkDocument(argv[1]);
-    } else {
-        for (int i = 1; i < argc - 1; i++) {
+    else if (strcmp(argv[first], "--compile") == 0) {
+        if (argc - first < 2) {
+            return EXIT_FAILURE;
+        }
+        for (int i = first + 2; i < argc; i++) {
+            readWords(argv[i]);
+        }
+        writeWords(argv[first + 1]);
+    }
+    else {
+        for (int i = first; i < argc - 1; i++) {
             readWords(argv[i]);
         }
-        checkDocument(argv[argc - 1]);
+        if (options.suggestions > 0) {
+            buildSuggestions();
+        }
+        checkDocument(argv[argc - 1], &options);
     }
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,394 @@
+/**
+Part of the suggest component. Every word on the word list is indexed under each string made by
+deleting up to MAX_DISTANCE of its characters. Two words within MAX_DISTANCE edits of each other
+always share such a string, so the candidates for a misspelled word are the words indexed under
+its own deletions. Only those few candidates have their edit distance worked out.
+@file suggest.c
+@author Matthew Kierski
+*/
+
+#include "suggest.h"
+#include "wordlist.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <ctype.h>
+
+/** Longest word that is indexed, or that gets suggestions */
+#define MAX_INDEXED 32
+/** Number of bits of the hash sorted on in each pass of the radix sort */
+#define RADIX_BITS 16
+
+/** A word on the word list, as the index sees it */
+typedef struct {
+    /** Characters of the word, which aren't null terminated */
+    char const *chars;
+    /** Number of characters in the word */
+    int len;
+} Entry;
+
+/** A deletion of a word, before the deletions are grouped by hash */
+typedef struct {
+    /** Hash of the characters left after the deletion */
+    uint32_t hash;
+    /** Index of the word the deletion came from */
+    uint32_t word;
+} Deletion;
+
+/** A slot of the index's hash table, holding every word with a deletion of one hash */
+typedef struct {
+    /** Hash of the deletion */
+    uint32_t hash;
+    /** Position of the deletion's first word in the postings */
+    uint32_t start;
+    /** Number of words with the deletion, or 0 if the slot is empty */
+    uint32_t count;
+} Slot;
+
+/** A word found within MAX_DISTANCE of the misspelled word */
+typedef struct {
+    /** Word that was found */
+    Entry const *entry;
+    /** Edit distance from the misspelled word */
+    int distance;
+} Match;
+
+//Global for words of the index
+static Entry *entries = NULL;
+static int entryCount = 0;
+
+//Global for deletions, while the index is being built
+static Deletion *deletions = NULL;
+static long deletionCount = 0;
+static long deletionCap = 0;
+
+//Global for words of each deletion, grouped by deletion and pointed to by the slots
+static uint32_t *postings = NULL;
+
+//Global hash table of deletions, and its number of slots (a power of two)
+static Slot *table = NULL;
+static long tableSize = 0;
+
+/**
+Hashes the characters of a word left after deleting up to two of them (FNV-1a)
+@param word word to hash
+@param len number of characters in word
+@param skip1 position of first deleted character, or -1 if none
+@param skip2 position of second deleted character, or -1 if none
+@return hash of the remaining characters
+*/
+static uint32_t hashDeletion( char const word[], int len, int skip1, int skip2 )
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < len; i++) {
+        if (i != skip1 && i != skip2) {
+            hash = (hash ^ (unsigned char) word[i]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+/**
+Calls a function with the hash of every string made by deleting up to MAX_DISTANCE characters
+of a word, including the word itself. A string can come up more than once.
+@param word word to delete characters from
+@param len number of characters in word
+@param visit function to call with each hash
+@param data passed on to visit
+*/
+static void forEachDeletion( char const word[], int len, void (*visit)( uint32_t hash, void *data ),
+                             void *data )
+{
+    visit(hashDeletion(word, len, -1, -1), data);
+    for (int i = 0; i < len; i++) {
+        visit(hashDeletion(word, len, i, -1), data);
+        for (int j = i + 1; j < len; j++) {
+            visit(hashDeletion(word, len, i, j), data);
+        }
+    }
+}
+
+/**
+Adds a deletion of the newest word to the list of deletions
+@param hash hash of the deletion
+@param data unused
+*/
+static void addDeletion( uint32_t hash, void *data )
+{
+    if (deletionCount == deletionCap) {
+        deletionCap = deletionCap ? deletionCap * 2 : 65536;
+        deletions = realloc(deletions, deletionCap * sizeof(Deletion));
+        if (!deletions) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    deletions[deletionCount++] = (Deletion) { hash, entryCount - 1 };
+}
+
+/**
+Adds a word to the index's words, and its deletions to the list of deletions
+@param word word to add
+@param len number of characters in word
+@param data capacity of the words array
+*/
+static void addEntry( char const word[], int len, void *data )
+{
+    if (len > MAX_INDEXED) {
+        return;
+    }
+    int *capacity = data;
+    if (entryCount == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 4096;
+        entries = realloc(entries, *capacity * sizeof(Entry));
+        if (!entries) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    entries[entryCount++] = (Entry) { word, len };
+    forEachDeletion(word, len, addDeletion, NULL);
+}
+
+/**
+Sorts the deletions by hash with a radix sort, RADIX_BITS bits at a time. Each pass is stable,
+and the deletions were made in order of word, so deletions with equal hashes stay in order of
+word.
+*/
+static void sortDeletions( void )
+{
+    Deletion *sorted = malloc(deletionCount * sizeof(Deletion) + 1);
+    long *counts = malloc((1 << RADIX_BITS) * sizeof(long));
+    if (!sorted || !counts) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int shift = 0; shift < 32; shift += RADIX_BITS) {
+        memset(counts, 0, (1 << RADIX_BITS) * sizeof(long));
+        for (long i = 0; i < deletionCount; i++) {
+            counts[deletions[i].hash >> shift & ((1 << RADIX_BITS) - 1)]++;
+        }
+        long start = 0;
+        for (int digit = 0; digit < 1 << RADIX_BITS; digit++) {
+            long count = counts[digit];
+            counts[digit] = start;
+            start += count;
+        }
+        for (long i = 0; i < deletionCount; i++) {
+            sorted[counts[deletions[i].hash >> shift & ((1 << RADIX_BITS) - 1)]++] = deletions[i];
+        }
+        Deletion *swap = deletions;
+        deletions = sorted;
+        sorted = swap;
+    }
+    free(sorted);
+    free(counts);
+}
+
+/**
+Finds the slot of a deletion's hash, or the empty slot where it would go
+@param hash hash of the deletion
+@return slot of the hash
+*/
+static Slot *findSlot( uint32_t hash )
+{
+    long i = hash & (tableSize - 1);
+    while (table[i].count != 0 && table[i].hash != hash) {
+        i = (i + 1) & (tableSize - 1);
+    }
+    return &table[i];
+}
+
+extern void buildSuggestions( void )
+{
+    int capacity = 0;
+    forEachWord(addEntry, &capacity);
+
+    //Sorting puts the words of each deletion together, and makes repeats of a deletion adjacent
+    sortDeletions();
+    postings = malloc((deletionCount + 1) * sizeof(uint32_t));
+    long groups = 0;
+    for (long i = 0; i < deletionCount; i++) {
+        groups += i == 0 || deletions[i].hash != deletions[i - 1].hash;
+    }
+    tableSize = 1;
+    while (tableSize < 2 * groups) {
+        tableSize *= 2;
+    }
+    table = calloc(tableSize, sizeof(Slot));
+    if (!postings || !table) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    long count = 0;
+    Slot *slot = NULL;
+    for (long i = 0; i < deletionCount; i++) {
+        if (i == 0 || deletions[i].hash != deletions[i - 1].hash) {
+            slot = findSlot(deletions[i].hash);
+            *slot = (Slot) { deletions[i].hash, count, 0 };
+        }
+        if (slot->count == 0 || postings[count - 1] != deletions[i].word) {
+            postings[count++] = deletions[i].word;
+            slot->count++;
+        }
+    }
+    free(deletions);
+    deletions = NULL;
+    deletionCount = deletionCap = 0;
+}
+
+/**
+Works out the edit distance between two words, giving up once it is sure to be more than
+MAX_DISTANCE
+@param a first word
+@param aLen number of characters in a
+@param b second word
+@param bLen number of characters in b
+@return edit distance, or MAX_DISTANCE + 1 if it is more than MAX_DISTANCE
+*/
+static int editDistance( char const a[], int aLen, char const b[], int bLen )
+{
+    if (abs(aLen - bLen) > MAX_DISTANCE) {
+        return MAX_DISTANCE + 1;
+    }
+    int rows[2][MAX_INDEXED + 1];
+    for (int j = 0; j <= bLen; j++) {
+        rows[0][j] = j;
+    }
+    for (int i = 1; i <= aLen; i++) {
+        int *prev = rows[(i - 1) % 2];
+        int *row = rows[i % 2];
+        row[0] = i;
+        int best = row[0];
+        for (int j = 1; j <= bLen; j++) {
+            int cost = prev[j - 1] + (a[i - 1] != b[j - 1]);
+            cost = prev[j] + 1 < cost ? prev[j] + 1 : cost;
+            cost = row[j - 1] + 1 < cost ? row[j - 1] + 1 : cost;
+            row[j] = cost;
+            best = cost < best ? cost : best;
+        }
+        if (best > MAX_DISTANCE) {
+            return MAX_DISTANCE + 1;
+        }
+    }
+    return rows[aLen % 2][bLen];
+}
+
+/**
+Orders matches by distance, then alphabetically
+@param a first match
+@param b second match
+@return negative, zero or positive as a comes before, with or after b
+*/
+static int compareMatches( void const *a, void const *b )
+{
+    Match const *x = a;
+    Match const *y = b;
+    if (x->distance != y->distance) {
+        return x->distance - y->distance;
+    }
+    int len = x->entry->len < y->entry->len ? x->entry->len : y->entry->len;
+    int order = memcmp(x->entry->chars, y->entry->chars, len);
+    return order ? order : x->entry->len - y->entry->len;
+}
+
+/** Candidates of one lookup, gathered by addCandidates from each deletion of the word */
+typedef struct {
+    /** Indexes of the candidate words, which can repeat */
+    uint32_t *words;
+    /** Number of candidates */
+    long count;
+    /** Number of candidates there is room for */
+    long capacity;
+} Candidates;
+
+/**
+Adds every word indexed under one deletion of the misspelled word to the candidates
+@param hash hash of the deletion
+@param data candidates of the lookup
+*/
+static void addCandidates( uint32_t hash, void *data )
+{
+    Candidates *candidates = data;
+    Slot const *slot = findSlot(hash);
+    if (candidates->count + slot->count > candidates->capacity) {
+        candidates->capacity = 2 * (candidates->count + slot->count);
+        candidates->words = realloc(candidates->words, candidates->capacity * sizeof(uint32_t));
+        if (!candidates->words) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    memcpy(candidates->words + candidates->count, postings + slot->start,
+           slot->count * sizeof(uint32_t));
+    candidates->count += slot->count;
+}
+
+/**
+Orders word indexes
+@param a first index
+@param b second index
+@return negative, zero or positive as a comes before, with or after b
+*/
+static int compareIndexes( void const *a, void const *b )
+{
+    uint32_t x = *(uint32_t const *) a;
+    uint32_t y = *(uint32_t const *) b;
+    return x < y ? -1 : x > y;
+}
+
+extern int suggestWords( char const word[], int len, int limit, char const *found[],
+                         int foundLen[] )
+{
+    if (len > MAX_INDEXED || tableSize == 0) {
+        return 0;
+    }
+    //Capitalized and all-capital words are checked in lower case, as lookupWord does
+    bool capitalized = word[0] >= 'A' && word[0] <= 'Z';
+    bool allCapitals = true;
+    for (int i = 0; i < len; i++) {
+        if (i > 0 && word[i] >= 'A' && word[i] <= 'Z') {
+            capitalized = false;
+        }
+        if (word[i] >= 'a' && word[i] <= 'z') {
+            allCapitals = false;
+        }
+    }
+    bool fold = capitalized || allCapitals;
+    char folded[MAX_INDEXED];
+    for (int i = 0; i < len; i++) {
+        folded[i] = fold ? tolower(word[i]) : word[i];
+    }
+
+    //Everything a lookup changes is its own, so lookups can run on several threads at once
+    Candidates candidates = { NULL, 0, 0 };
+    forEachDeletion(folded, len, addCandidates, &candidates);
+    qsort(candidates.words, candidates.count, sizeof(uint32_t), compareIndexes);
+    Match *matches = malloc((candidates.count + 1) * sizeof(Match));
+    if (!matches) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    int matchCount = 0;
+    for (long i = 0; i < candidates.count; i++) {
+        if (i > 0 && candidates.words[i] == candidates.words[i - 1]) {
+            continue;
+        }
+        Entry const *entry = &entries[candidates.words[i]];
+        int distance = editDistance(folded, len, entry->chars, entry->len);
+        if (distance <= MAX_DISTANCE) {
+            matches[matchCount++] = (Match) { entry, distance };
+        }
+    }
+    qsort(matches, matchCount, sizeof(Match), compareMatches);
+    int count = matchCount < limit ? matchCount : limit;
+    for (int i = 0; i < count; i++) {
+        found[i] = matches[i].entry->chars;
+        foundLen[i] = matches[i].entry->len;
+    }
+    free(matches);
+    free(candidates.words);
+    return count;
+}
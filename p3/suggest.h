@@ -0,0 +1,30 @@
+/**
+Serves as the header file of the suggest component. Provides methods that find words on the
+word list close to a misspelled word, using an index of the words with up to MAX_DISTANCE
+characters deleted (the SymSpell method).
+@file suggest.h
+@author Matthew Kierski
+*/
+
+/** Largest edit distance of a suggestion from the misspelled word */
+#define MAX_DISTANCE 2
+
+/**
+Builds the suggestion index from every word on the word list. Must be called after all word
+lists are read, and before suggestWords.
+*/
+void buildSuggestions( void );
+
+/**
+Finds the words on the word list closest to a misspelled word, within MAX_DISTANCE
+insertions, deletions or substitutions. Closer words come first, and words at the same
+distance come in alphabetical order. A capitalized or all-capital word is matched in
+lower case. Safe to call from several threads at once.
+@param word word to find suggestions for
+@param len number of characters in word
+@param limit most suggestions to give
+@param found filled in with the suggested words, which aren't null terminated
+@param foundLen filled in with the number of characters in each suggested word
+@return number of suggestions found
+*/
+int suggestWords( char const word[], int len, int limit, char const *found[], int foundLen[] );
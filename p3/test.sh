@@ -139,7 +139,7 @@ if [ -x spellcheck ] ; then
     echo "Test 16: ./spellcheck words-h.txt words-d.txt input-16.txt"
     ./spellcheck words-h.txt words-d.txt input-16.txt > output.txt 2> stderr.txt
     STATUS=$?
-    checkResults 16 1 $STATUS
+    checkResults 16 0 $STATUS
 
     rm -f output.txt stderr.txt
     echo "Test 17: ./spellcheck words-k.txt input-17.txt"
@@ -159,6 +159,78 @@ if [ -x spellcheck ] ; then
     STATUS=$?
     checkResults 19 1 $STATUS
 
+    rm -f output.txt stderr.txt dict.bin
+    echo "Test 20: ./spellcheck --compile dict.bin words-e.txt words-j.txt; ./spellcheck dict.bin input-15.txt"
+    ./spellcheck --compile dict.bin words-e.txt words-j.txt > output.txt 2> stderr.txt &&
+        ./spellcheck dict.bin input-15.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 20 0 $STATUS
+    rm -f dict.bin
+
+    rm -f output.txt stderr.txt
+    echo "Test 21: ./spellcheck --fp-rate=0.5 words-e.txt words-f.txt input-09.txt"
+    ./spellcheck --fp-rate=0.5 words-e.txt words-f.txt input-09.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 21 0 $STATUS
+
+    rm -f output.txt stderr.txt
+    echo "Test 22: ./spellcheck --suggest words-e.txt input-09.txt"
+    ./spellcheck --suggest words-e.txt input-09.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 22 0 $STATUS
+
+    rm -f output.txt stderr.txt
+    echo "Test 23: ./spellcheck --line-limit=75 words-e.txt input-11.txt"
+    ./spellcheck --line-limit=75 words-e.txt input-11.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 23 0 $STATUS
+
+    rm -f output.txt stderr.txt
+    echo "Test 24: ./spellcheck --threads=4 --suggest words-e.txt input-11.txt"
+    ./spellcheck --threads=4 --suggest words-e.txt input-11.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 24 0 $STATUS
+
+    rm -f output.txt stderr.txt
+    echo "Test 25: ./tokentest input-*.txt words-*.txt"
+    ./tokentest input-*.txt words-*.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 25 0 $STATUS
+
+    rm -f output.txt stderr.txt
+    echo "Test 26: ./spellcheck --stats words-e.txt input-11.txt"
+    ./spellcheck --stats words-e.txt input-11.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 26 0 $STATUS
+
+    rm -f output.txt stderr.txt
+    echo "Test 27: ./spellcheck dict.bin input-15.txt, with the first slot of dict.bin corrupted"
+    ./spellcheck --compile dict.bin words-e.txt words-j.txt > output.txt 2> stderr.txt &&
+        printf '\377\377\377\377\377\377\377\377' |
+        dd of=dict.bin bs=1 seek=40 conv=notrunc 2> /dev/null &&
+        ./spellcheck dict.bin input-15.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 27 1 $STATUS
+    rm -f dict.bin
+
+    rm -f output.txt stderr.txt
+    echo "Test 28: ./spellcheck --suggest=1 words-e.txt input-28.txt"
+    ./spellcheck --suggest=1 words-e.txt input-28.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 28 0 $STATUS
+
+    rm -f output.txt stderr.txt
+    echo "Test 29: ./spellcheck words-m.txt input-17.txt"
+    ./spellcheck words-m.txt input-17.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 29 1 $STATUS
+
+    rm -f output.txt stderr.txt
+    echo "Test 30: ./spellcheck words-n.txt input-30.txt"
+    ./spellcheck words-n.txt input-30.txt > output.txt 2> stderr.txt
+    STATUS=$?
+    checkResults 30 0 $STATUS
+
 else
     echo "**** Your program couldn't be tested since it didn't compile successfully."
     FAIL=1
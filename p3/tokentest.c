@@ -0,0 +1,105 @@
+/**
+Tests the classify component. Splits each file given on the command line into runs of word
+characters and runs of separators, once with the masks from classify and once a character
+at a time with wordChar, the way documents were split before classify, and reports whether
+the two agree. Each file is split from every starting offset up to MASK_BITS, so every
+alignment of the vector loads and every length of the short last group gets tried.
+@file tokentest.c
+@author Matthew Kierski
+*/
+
+#include "classify.h"
+#include "wordlist.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+Finds the end of a run one character at a time
+@param text text the run is in
+@param pos position the run starts at
+@param len number of characters in text
+@return position just past the end of the run
+*/
+static long scalarRun( char const text[], long pos, long len )
+{
+    bool word = wordChar(text[pos]);
+    while (pos < len && wordChar(text[pos]) == word && text[pos] != '\n') {
+        pos++;
+    }
+    return pos;
+}
+
+/**
+Splits a block of text into runs both ways, reporting the first place they disagree
+@param fileName name of the file the text came from
+@param text text to split
+@param len number of characters in text
+@param words space for the mask of word characters
+@param stops space for the mask of characters that end runs of separators
+@return number of runs, or -1 if the two ways disagree
+*/
+static long checkRuns( char const fileName[], char const text[], long len, uint64_t words[],
+                       uint64_t stops[] )
+{
+    classifyText(text, len, words, stops);
+    long runs = 0;
+    long pos = 0;
+    while (pos < len) {
+        bool word = words[pos / MASK_BITS] >> (pos % MASK_BITS) & 1;
+        long end = findBit(word ? words : stops, pos, len, !word);
+        if (word != wordChar(text[pos]) || end != scalarRun(text, pos, len)) {
+            printf("%s: run at %ld differs\n", fileName, pos);
+            return -1;
+        }
+        //A separator run that starts with a newline is the newline alone
+        pos = end > pos ? end : pos + 1;
+        runs++;
+    }
+    return runs;
+}
+
+/**
+Starting point of the program. Reads each file and checks the runs found in it.
+@param argc number of command line arguments
+@param argv files to check
+@return exit status, 1 if the runs differ for any file
+*/
+int main( int argc, char *argv[] )
+{
+    int status = EXIT_SUCCESS;
+    for (int i = 1; i < argc; i++) {
+        FILE *fp = fopen(argv[i], "rb");
+        if (!fp) {
+            fprintf(stderr, "Can't open file: %s\n", argv[i]);
+            exit(EXIT_FAILURE);
+        }
+        fseek(fp, 0, SEEK_END);
+        long len = ftell(fp);
+        rewind(fp);
+        char *text = malloc(len + 1);
+        uint64_t *words = malloc((maskLength(len) + 1) * sizeof(uint64_t));
+        uint64_t *stops = malloc((maskLength(len) + 1) * sizeof(uint64_t));
+        if (!text || !words || !stops || fread(text, 1, len, fp) != (size_t) len) {
+            fprintf(stderr, "Can't read file: %s\n", argv[i]);
+            exit(EXIT_FAILURE);
+        }
+        fclose(fp);
+
+        long runs = checkRuns(argv[i], text, len, words, stops);
+        for (long offset = 1; runs >= 0 && offset < MASK_BITS && offset < len; offset++) {
+            if (checkRuns(argv[i], text + offset, len - offset, words, stops) < 0) {
+                runs = -1;
+            }
+        }
+        if (runs < 0) {
+            status = EXIT_FAILURE;
+        }
+        else {
+            printf("%s: %ld runs\n", argv[i], runs);
+        }
+        free(text);
+        free(words);
+        free(stops);
+    }
+    return status;
+}
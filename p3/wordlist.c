@@ -1,52 +1,555 @@
 /**
 Part of the wordlist component. Implements the methods needed for reading word lists from files,
-storing and managing the in-memory word list, and checking words against the list.
+storing and managing the in-memory word list, and checking words against the list. The words'
+characters are kept back to back in one growable arena, each word recorded by its 32-bit offset
+and length, so a list may hold up to 2^30 words with up to 4 GiB of characters in all; reading
+more than that stops with "Too many words". Words are indexed by an open-addressing hash table,
+so adding or looking up a word doesn't depend on how many words are already on the list.
+A compiled dictionary is the same arena, records and table written to a file, so it can be
+mapped into memory and used as it is. A blocked Bloom filter in front of each table turns away
+most words that aren't on the list after touching a single cache line of the filter; a compiled
+dictionary carries its filter in the file too, so loading one doesn't hash a single word.
 @file wordlist.c
 @author Matthew Kierski
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "wordlist.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/** Initial capacity of the string arena, in characters */
+#define INITIAL_ARENA 65536
+/** Initial capacity of the word records */
+#define INITIAL_WORDS 4096
+/** Initial number of slots in the hash table; always a power of two, kept at most half full */
+#define INITIAL_SLOTS 8192
+/** Longest word folded to lower case on the stack before a second lookup; longer words are
+ folded into allocated memory */
+#define FOLD_LEN 64
+/** Most characters the words on a list may have in all, so every offset fits in a Word */
+#define MAX_ARENA UINT32_MAX
+/** Most words on a list, so the hash table's size fits in a Header */
+#define MAX_WORDS (1L << 30)
+/** First bytes of a compiled dictionary; the last one is the format version */
+#define MAGIC "SPELLDX2"
+/** Number of bytes in MAGIC */
+#define MAGIC_LEN 8
+/** Number of bits in a block of the Bloom filter, the size of a cache line */
+#define BLOCK_BITS 512
+/** Number of bits needed to pick one bit of a block */
+#define BLOCK_SHIFT 9
+/** Number of 64-bit words in a block of the Bloom filter */
+#define BLOCK_WORDS (BLOCK_BITS / 64)
+
+/** A word on the word list, stored as a range of the string arena */
+typedef struct {
+    /** Position of the word's first character in the arena */
+    uint32_t offset;
+    /** Number of characters in the word */
+    uint32_t length;
+} Word;
+
+/** A slot of the hash table */
+typedef struct {
+    /** Hash of the word in the slot */
+    uint32_t hash;
+    /** Index of the word in the word list plus one, or 0 if the slot is empty */
+    uint32_t index;
+} Slot;
+
+/** Start of a compiled dictionary, followed by its slots, its words, its arena and, from the
+ next multiple of a block's size, its Bloom filter */
+typedef struct {
+    /** MAGIC, to recognize compiled dictionaries among word list files */
+    char magic[MAGIC_LEN];
+    /** Number of words */
+    uint32_t count;
+    /** Number of slots in the hash table */
+    uint32_t tableSize;
+    /** Number of characters in the arena */
+    uint64_t arenaLen;
+    /** Number of blocks in the Bloom filter */
+    uint64_t blocks;
+    /** Number of bits set in a block for each word */
+    uint32_t probes;
+    /** Always 0, so no part of the header is left unwritten */
+    uint32_t padding;
+} Header;
+
+/** A set of words and the hash table indexing them */
+typedef struct {
+    /** Characters of every word on the list, back to back with no terminators */
+    char *arena;
+    /** Number of characters used in the arena */
+    long arenaLen;
+    /** Number of characters allocated for the arena */
+    long arenaCap;
+    /** Words on the list */
+    Word *words;
+    /** Number of words on the list */
+    long count;
+    /** Number of words allocated for */
+    long capacity;
+    /** Hash table indexing the words */
+    Slot *table;
+    /** Number of slots in the hash table */
+    long tableSize;
+    /** Bloom filter of the words' hashes, BLOCK_WORDS words per block */
+    uint64_t *filter;
+    /** Number of blocks in the filter */
+    long blocks;
+    /** Number of bits set in a block for each word */
+    int probes;
+} Dictionary;
+
+//Global for words read from word list files
+static Dictionary loaded;
+
+//Global for the compiled dictionary mapped from a file, which is never changed
+static Dictionary mapped;
+
+//Global for the fraction of words not on the list that the Bloom filters should let through
+static double falsePositiveRate = DEFAULT_FP_RATE;
+
+extern uint32_t hashWord( char const word[], int len )
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < len; i++) {
+        hash = (hash ^ (unsigned char) word[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+Spreads the bits of a value over 64 bits (the SplitMix64 finalizer), so the Bloom filter can
+take several independent-looking values from one word hash
+@param x value to mix
+@return mixed value
+*/
+static uint64_t mixHash( uint64_t x )
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+Gives the block of a dictionary's Bloom filter that a hash belongs to
+@param dict dictionary whose filter to use
+@param mix mixed hash of a word; the top 32 bits pick the block
+@return first 64-bit word of the block
+*/
+static uint64_t *filterBlock( Dictionary const *dict, uint64_t mix )
+{
+    return dict->filter + ((mix >> 32) * dict->blocks >> 32) * BLOCK_WORDS;
+}
+
+/**
+Gives the bit of a block set by one of a word's probes. Each probe takes its own BLOCK_SHIFT
+bits of the mixed hash, which is mixed again with the probe's number when they run out.
+@param mix mixed hash of the word
+@param bits bits left over from earlier probes, updated to the ones left after this probe
+@param probe number of the probe, counting from 0
+@return bit of the block
+*/
+static int probeBit( uint64_t mix, uint64_t *bits, int probe )
+{
+    if (probe % (64 / BLOCK_SHIFT) == 0) {
+        *bits = mixHash(mix + probe);
+    }
+    int bit = *bits & (BLOCK_BITS - 1);
+    *bits >>= BLOCK_SHIFT;
+    return bit;
+}
+
+/**
+Adds a word's hash to a dictionary's Bloom filter
+@param dict dictionary whose filter to add to
+@param hash hash of the word
+*/
+static void addToFilter( Dictionary *dict, uint32_t hash )
+{
+    uint64_t mix = mixHash(hash);
+    uint64_t *block = filterBlock(dict, mix);
+    uint64_t bits = 0;
+    for (int i = 0; i < dict->probes; i++) {
+        int bit = probeBit(mix, &bits, i);
+        block[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+/**
+Checks a dictionary's Bloom filter for a word's hash
+@param dict dictionary whose filter to check
+@param hash hash of the word
+@return false if the word is certainly not in the dictionary, true if it may be
+*/
+static bool mayContain( Dictionary const *dict, uint32_t hash )
+{
+    uint64_t mix = mixHash(hash);
+    uint64_t const *block = filterBlock(dict, mix);
+    uint64_t bits = 0;
+    for (int i = 0; i < dict->probes; i++) {
+        int bit = probeBit(mix, &bits, i);
+        if (!(block[bit / 64] >> (bit % 64) & 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+Works out the false positive rate of a blocked Bloom filter. Words don't spread evenly over
+the blocks, and the fuller blocks let more words through, so the rate is averaged over the
+Poisson distribution of words per block.
+@param perBlock average number of words in a block
+@param probes number of bits set in a block for each word
+@return expected false positive rate
+*/
+static double blockedRate( double perBlock, int probes )
+{
+    double rate = 0;
+    double chance = exp(-perBlock);
+    for (int words = 0; words < perBlock + 20 * sqrt(perBlock) + 20; words++) {
+        double unset = pow(1 - 1.0 / BLOCK_BITS, (double) probes * words);
+        rate += chance * pow(1 - unset, probes);
+        chance *= perBlock / (words + 1);
+    }
+    return rate;
+}
+
+/**
+Builds a new Bloom filter for a dictionary, sized so that it gives falsePositiveRate once it
+holds a given number of words, and adds every word already in the dictionary's table to it
+@param dict dictionary to build the filter of
+@param words number of words the filter is sized for
+*/
+static void buildFilter( Dictionary *dict, long words )
+{
+    //An ideal filter needs -ln(p) / ln(2)^2 bits per word and ln(2) times that many probes;
+    //a blocked one needs a little more, so grow it until it meets the rate
+    double ln2 = log(2.0);
+    double bitsPerWord = -log(falsePositiveRate) / (ln2 * ln2);
+    int probes = 1;
+    for (int tries = 0; tries < 100; tries++, bitsPerWord *= 1.05) {
+        probes = (int) lround(bitsPerWord * ln2);
+        probes = probes > 0 ? probes : 1;
+        if (blockedRate(BLOCK_BITS / bitsPerWord, probes) <= falsePositiveRate) {
+            break;
+        }
+    }
+    free(dict->filter);
+    dict->blocks = (long) ceil(words * bitsPerWord / BLOCK_BITS);
+    dict->blocks = dict->blocks > 0 ? dict->blocks : 1;
+    dict->probes = probes;
+    //Align the filter so each block is exactly one cache line
+    void *filter;
+    if (posix_memalign(&filter, BLOCK_BITS / 8, dict->blocks * (BLOCK_BITS / 8)) != 0) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    dict->filter = filter;
+    memset(dict->filter, 0, dict->blocks * (BLOCK_BITS / 8));
+    for (long i = 0; i < dict->tableSize; i++) {
+        if (dict->table[i].index != 0) {
+            addToFilter(dict, dict->table[i].hash);
+        }
+    }
+}
+
+/**
+Finds the slot that holds a word, or the empty slot where it would go
+@param dict dictionary to look in, which must have a table
+@param word word to find
+@param len number of characters in word
+@param hash hash of the word
+@return position of the slot in the table
+*/
+static long findSlot( Dictionary const *dict, char const word[], int len, uint32_t hash )
+{
+    long i = hash & (dict->tableSize - 1);
+    //Only words with the same hash need their characters compared
+    while (dict->table[i].index != 0) {
+        Word const *entry = &dict->words[dict->table[i].index - 1];
+        if (dict->table[i].hash == hash && entry->length == len &&
+            memcmp(dict->arena + entry->offset, word, len) == 0) {
+            break;
+        }
+        i = (i + 1) & (dict->tableSize - 1);
+    }
+    return i;
+}
 
-/** Return value for lookupWord when word is pronoun */
-#define PRONOUN 2
-/** Return value for lookupWord when word is non pronoun */
-#define NON_PRONOUN 1
-/** Return value for lookupWord when word is not found */
-#define WORD_NOT_FOUND 0
-/** Max length of word (including null terminator) */
-#define WORD_LEN 13
-/** Max length of word list */
-#define MAX_WORDS 40000
+/**
+Determines if a word is on the word list, either read from a file or compiled
+@param word word to find
+@param len number of characters in word
+@return true if the word is on the list
+*/
+static bool containsWord( char const word[], int len )
+{
+    uint32_t hash = hashWord(word, len);
+    if (mapped.count > 0 && mayContain(&mapped, hash) &&
+        mapped.table[findSlot(&mapped, word, len, hash)].index != 0) {
+        return true;
+    }
+    return loaded.count > 0 && mayContain(&loaded, hash) &&
+           loaded.table[findSlot(&loaded, word, len, hash)].index != 0;
+}
 
-//Global for word list
-char static wordList[MAX_WORDS][WORD_LEN];
+/**
+Grows a dynamically allocated array to at least a given capacity, doubling it so that
+growing one element at a time takes linear time overall. Exits if memory runs out.
+@param array array to grow
+@param cap current capacity, updated to the new one
+@param need capacity required
+@param size size of one element
+@return grown array
+*/
+static void *grow( void *array, long *cap, long need, size_t size )
+{
+    if (need <= *cap) {
+        return array;
+    }
+    long newCap = *cap ? *cap : need;
+    while (newCap < need) {
+        newCap *= 2;
+    }
+    array = realloc(array, newCap * size);
+    if (!array) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    *cap = newCap;
+    return array;
+}
 
-//Global for size of word list
-static int count = 0;
+/**
+Doubles the number of slots in the hash table of the loaded words, moving every word to its
+new slot, and rebuilds their Bloom filter for the new size. The stored hashes mean no word
+has to be hashed again.
+*/
+static void growTable( void )
+{
+    Slot *old = loaded.table;
+    long oldSize = loaded.tableSize;
+    loaded.tableSize = oldSize ? oldSize * 2 : INITIAL_SLOTS;
+    loaded.table = calloc(loaded.tableSize, sizeof(Slot));
+    if (!loaded.table) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (long i = 0; i < oldSize; i++) {
+        if (old[i].index != 0) {
+            long j = old[i].hash & (loaded.tableSize - 1);
+            while (loaded.table[j].index != 0) {
+                j = (j + 1) & (loaded.tableSize - 1);
+            }
+            loaded.table[j] = old[i];
+        }
+    }
+    free(old);
+    buildFilter(&loaded, loaded.tableSize / 2);
+}
+
+/**
+Adds the word at the end of the loaded arena to the word list, or gives its space back if it
+is already on the list
+@param start position of the word's first character in the arena
+*/
+static void keepWord( long start )
+{
+    if (loaded.arenaLen > MAX_ARENA) {
+        fprintf(stderr, "Too many words\n");
+        exit(EXIT_FAILURE);
+    }
+    char const *word = loaded.arena + start;
+    int len = loaded.arenaLen - start;
+    loaded.arenaLen = start;
+    uint32_t hash = hashWord(word, len);
+    if (mapped.count > 0 && mapped.table[findSlot(&mapped, word, len, hash)].index != 0) {
+        return;
+    }
+    long i = findSlot(&loaded, word, len, hash);
+    if (loaded.table[i].index == 0) {
+        if (loaded.count == MAX_WORDS) {
+            fprintf(stderr, "Too many words\n");
+            exit(EXIT_FAILURE);
+        }
+        loaded.words = grow(loaded.words, &loaded.capacity, loaded.count + 1, sizeof(Word));
+        loaded.words[loaded.count] = (Word) { start, len };
+        loaded.arenaLen = start + len;
+        loaded.count++;
+        loaded.table[i] = (Slot) { hash, loaded.count };
+        addToFilter(&loaded, hash);
+        if (loaded.count * 2 > loaded.tableSize) {
+            growTable();
+        }
+    }
+}
+
+/**
+Gives the position of a compiled dictionary's Bloom filter in its file, the end of its arena
+rounded up to a whole block so the mapped filter's blocks line up with cache lines
+@param header header of the compiled dictionary
+@return position of the filter
+*/
+static uint64_t filterOffset( Header const *header )
+{
+    uint64_t end = sizeof(Header) + (uint64_t) header->tableSize * sizeof(Slot) +
+                   (uint64_t) header->count * sizeof(Word) + header->arenaLen;
+    return (end + BLOCK_BITS / 8 - 1) / (BLOCK_BITS / 8) * (BLOCK_BITS / 8);
+}
+
+/**
+Maps a compiled dictionary into memory, read-only and shared with any other process using it
+@param fileName name of file to map
+*/
+static void mapWords( char const fileName[] )
+{
+    if (mapped.count > 0) {
+        fprintf(stderr, "Only one compiled dictionary allowed\n");
+        exit(EXIT_FAILURE);
+    }
+    int fd = open(fileName, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        fprintf(stderr, "Can't open file: %s\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    if (info.st_size < sizeof(Header)) {
+        fprintf(stderr, "Invalid dictionary: %s\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    char *base = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Can't open file: %s\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+
+    //Check the sizes in the header against the file before trusting them
+    Header const *header = (Header const *) base;
+    if (memcmp(header->magic, MAGIC, MAGIC_LEN) != 0 || header->blocks == 0 ||
+        header->blocks > (uint64_t) info.st_size || header->probes == 0 ||
+        header->probes > BLOCK_BITS || header->arenaLen > (uint64_t) info.st_size ||
+        filterOffset(header) + header->blocks * (BLOCK_BITS / 8) != (uint64_t) info.st_size ||
+        header->tableSize == 0 ||
+        (header->tableSize & (header->tableSize - 1)) != 0 ||
+        header->count >= header->tableSize) {
+        fprintf(stderr, "Invalid dictionary: %s\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    Slot const *table = (Slot const *) (base + sizeof(Header));
+    Word const *words = (Word const *) (table + header->tableSize);
+
+    //Every slot and word has to point inside the file too, or a lookup could read past it
+    long used = 0;
+    for (long i = 0; i < header->tableSize; i++) {
+        if (table[i].index > header->count) {
+            used = -1;
+            break;
+        }
+        used += table[i].index != 0;
+    }
+    for (long i = 0; used == header->count && i < header->count; i++) {
+        if ((uint64_t) words[i].offset + words[i].length > header->arenaLen) {
+            used = -1;
+        }
+    }
+    if (used != header->count) {
+        fprintf(stderr, "Invalid dictionary: %s\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    mapped.count = header->count;
+    mapped.tableSize = header->tableSize;
+    mapped.table = (Slot *) table;
+    mapped.words = (Word *) words;
+    mapped.arena = (char *) (mapped.words + mapped.count);
+    mapped.arenaLen = header->arenaLen;
+    mapped.filter = (uint64_t *) (base + filterOffset(header));
+    mapped.blocks = header->blocks;
+    mapped.probes = header->probes;
+}
+
+/**
+Determines if a word has any capital letters
+@param word word to check
+@param len number of characters in word
+@return true if any character is a capital
+*/
+static bool hasCapital( char const word[], int len )
+{
+    for (int i = 0; i < len; i++) {
+        if (word[i] >= 'A' && word[i] <= 'Z') {
+            return true;
+        }
+    }
+    return false;
+}
+
+extern void setFalsePositiveRate( double rate )
+{
+    falsePositiveRate = rate;
+}
 
 extern bool wordChar( char ch ) {
     return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch == '\'');
 }
 
-extern int lookupWord( char const word[] )
+extern int lookupWord( char const word[], int len )
 {
-    for (int i = 0; i < count; i++) {
-        if (strcmp(word, wordList[i]) == 0) {
-            int length = strlen(word);
-            for (int j = 0; j < length; i++) {
-                if (word[i] >= 'A' && word[i] <= 'Z') {
-                    return PRONOUN;
-                } else {
-                    return NON_PRONOUN;
-                }
-            }
+    if (containsWord(word, len)) {
+        return hasCapital(word, len) ? PRONOUN : NON_PRONOUN;
+    }
+
+    //Capitalized and all-capital forms of words with no capitals are spelled correctly too
+    bool capitalized = word[0] >= 'A' && word[0] <= 'Z' && !hasCapital(word + 1, len - 1);
+    bool allCapitals = !capitalized;
+    for (int i = 0; i < len; i++) {
+        if (word[i] >= 'a' && word[i] <= 'z') {
+            allCapitals = false;
         }
     }
-    return WORD_NOT_FOUND;
+    if (!capitalized && !allCapitals) {
+        return WORD_NOT_FOUND;
+    }
+    char buffer[FOLD_LEN];
+    char *lower = len > FOLD_LEN ? malloc(len) : buffer;
+    if (!lower) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < len; i++) {
+        lower[i] = tolower(word[i]);
+    }
+    bool found = containsWord(lower, len);
+    if (lower != buffer) {
+        free(lower);
+    }
+    return found ? NON_PRONOUN : WORD_NOT_FOUND;
+}
+
+extern void forEachWord( void (*visit)( char const word[], int len, void *data ), void *data )
+{
+    for (long i = 0; i < mapped.count; i++) {
+        visit(mapped.arena + mapped.words[i].offset, mapped.words[i].length, data);
+    }
+    for (long i = 0; i < loaded.count; i++) {
+        visit(loaded.arena + loaded.words[i].offset, loaded.words[i].length, data);
+    }
 }
 
 extern void readWords (char const fileName[] )
@@ -56,35 +559,81 @@ extern void readWords (char const fileName[] )
         fprintf(stderr, "Can't open file: %s\n", fileName);
         exit(EXIT_FAILURE);
     }
-    char word[WORD_LEN];
-    while (fscanf(fp, "%12s", word) == 1 ) {
-        bool duplicate = false;
-        if (count > MAX_WORDS) {
-            fprintf(stderr, "Too many words\n");
-            exit(EXIT_FAILURE);
+    //A compiled dictionary of another version is recognized too, so mapWords can reject it
+    char magic[MAGIC_LEN];
+    if (fread(magic, 1, MAGIC_LEN, fp) == MAGIC_LEN &&
+        memcmp(magic, MAGIC, MAGIC_LEN - 1) == 0) {
+        fclose(fp);
+        mapWords(fileName);
+        return;
+    }
+    rewind(fp);
+    if (!loaded.arena) {
+        loaded.arena = grow(NULL, &loaded.arenaCap, INITIAL_ARENA, 1);
+        loaded.words = grow(NULL, &loaded.capacity, INITIAL_WORDS, sizeof(Word));
+        growTable();
+    }
+    int line = 1;
+    int ch = getc(fp);
+    while (ch != EOF) {
+        if (isspace(ch)) {
+            line += ch == '\n';
+            ch = getc(fp);
+            continue;
         }
-        //Ensure valid word
-        for (int i = 0; i < strlen(word); i++) {
-            if (!wordChar(word[i])) {
-                fprintf(stderr, "Invalid word at %s:%d\n", fileName, count);
+        //Copy the word to the end of the arena, and give the space back if it's a duplicate
+        long start = loaded.arenaLen;
+        while (ch != EOF && !isspace(ch)) {
+            if (!wordChar(ch)) {
+                fprintf(stderr, "Invalid word at %s:%d\n", fileName, line);
                 exit(EXIT_FAILURE);
             }
+            loaded.arena = grow(loaded.arena, &loaded.arenaCap, loaded.arenaLen + 1, 1);
+            loaded.arena[loaded.arenaLen++] = ch;
+            ch = getc(fp);
         }
-
-        if (count == 0) {
-            strcpy(wordList[0], word);
-            count++;
-        } else {
-            for (int i = 0; i < count; i++) {
-                if (strcmp(word, wordList[i]) == 0) {
-                    duplicate = true;
-                }
-            }
-        }
-        if (!duplicate) {
-            strcpy(wordList[count], word);
-            count++;
-        }
+        keepWord(start);
     }
     fclose(fp);
 }
+
+extern void writeWords( char const fileName[] )
+{
+    if (!loaded.arena) {
+        loaded.arena = grow(NULL, &loaded.arenaCap, INITIAL_ARENA, 1);
+        growTable();
+    }
+    //Words of a compiled dictionary given as a word list are compiled in with the rest
+    Dictionary const source = mapped;
+    mapped.count = 0;
+    for (long i = 0; i < source.count; i++) {
+        Word const *word = &source.words[i];
+        long start = loaded.arenaLen;
+        loaded.arena = grow(loaded.arena, &loaded.arenaCap, start + word->length, 1);
+        memcpy(loaded.arena + start, source.arena + word->offset, word->length);
+        loaded.arenaLen += word->length;
+        keepWord(start);
+    }
+
+    FILE *fp = fopen(fileName, "wb");
+    if (!fp) {
+        fprintf(stderr, "Can't open file: %s\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    //The filter was sized for the table growing to full; size it for just these words
+    buildFilter(&loaded, loaded.count);
+    Header header = { MAGIC, loaded.count, loaded.tableSize, loaded.arenaLen, loaded.blocks,
+                      loaded.probes, 0 };
+    fwrite(&header, sizeof(Header), 1, fp);
+    fwrite(loaded.table, sizeof(Slot), loaded.tableSize, fp);
+    fwrite(loaded.words, sizeof(Word), loaded.count, fp);
+    fwrite(loaded.arena, 1, loaded.arenaLen, fp);
+    for (uint64_t pos = filterOffset(&header) - ftell(fp); pos > 0; pos--) {
+        putc(0, fp);
+    }
+    fwrite(loaded.filter, BLOCK_BITS / 8, loaded.blocks, fp);
+    if (ferror(fp) | fclose(fp)) {
+        fprintf(stderr, "Can't write file: %s\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+}
@@ -6,6 +6,33 @@ checking words against the list.
 @author Matthew Kierski
 */
 #include <stdbool.h>
+#include <stdint.h>
+
+/** Return value for lookupWord when word is pronoun */
+#define PRONOUN 2
+/** Return value for lookupWord when word is non pronoun */
+#define NON_PRONOUN 1
+/** Return value for lookupWord when word is not found */
+#define WORD_NOT_FOUND 0
+/** Default fraction of words not on the list that get past the Bloom filter */
+#define DEFAULT_FP_RATE 0.01
+
+/**
+Sets the fraction of words not on the list that the Bloom filter in front of the word list
+may let through to a full lookup. A lower rate uses more memory. Must be called before any
+word lists are read.
+@param rate false positive rate, greater than 0 and less than 1
+*/
+void setFalsePositiveRate( double rate );
+
+/**
+Hashes the characters of a word (FNV-1a). The word list's table and the lookup cache both use
+this hash.
+@param word word to hash
+@param len number of characters in word
+@return hash of the word
+*/
+uint32_t hashWord( char const word[], int len );
 
 /**
 Determines if a given character can be part of a valid word
@@ -16,14 +43,32 @@ bool wordChar( char ch );
 
 /**
 Given a word from document, looks up the word list and returns whether a given
-word is a proper noun, non-proper noun that is spelled correctly, or an inavlid word
+word is a proper noun, non-proper noun that is spelled correctly, or an inavlid word.
+A word on the list with no capitals also matches when capitalized or in all capitals.
 @param word word to evaluate
+@param len number of characters in word
 @return 2 if proper noun, 1 if nonproper, 0 if invalid
 */
-int lookupWord( char const word[] );
+int lookupWord( char const word[], int len );
+
+/**
+Calls a function with every word on the word list, in no particular order. The words stay in
+place as long as no more word lists are read.
+@param visit function to call with each word and its number of characters
+@param data passed on to visit
+*/
+void forEachWord( void (*visit)( char const word[], int len, void *data ), void *data );
 
 /**
 Reads all words from a given file and adds new unique words to in-memory word list.
+A compiled dictionary written by writeWords is mapped into memory instead of read.
 @param fileName name of file to read
 */
 void readWords (char const fileName[] );
+
+/**
+Writes every word on the word list to a compiled dictionary, which readWords can later
+map into memory without parsing or checking any words.
+@param fileName name of file to write
+*/
+void writeWords( char const fileName[] );